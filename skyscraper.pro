@@ -6,6 +6,7 @@ CONFIG += release
 win32:CONFIG += console
 QT += core network xml
 QMAKE_CXXFLAGS += -std=c++11
+LIBS += -lz
 
 unix:target.path=/usr/local/bin
 unix:target.files=Skyscraper Skyscraper.app/Contents/MacOS/Skyscraper
@@ -72,7 +73,21 @@ HEADERS += src/skyscraper.h \
            src/fxrotate.h \
            src/fxscanlines.h \
            src/nametools.h \
-           src/queue.h
+           src/queue.h \
+           src/zipreader.h \
+           src/checksumtools.h \
+           src/disktools.h \
+           src/boundedqueue.h \
+           src/hashworker.h \
+           src/ratelimiter.h \
+           src/threadgovernor.h \
+           src/frontendoutput.h \
+           src/batch.h \
+           src/daemon.h \
+           src/fakescraper.h \
+           src/videoworker.h \
+           src/memoryguard.h \
+           src/entryspill.h
 
 SOURCES += src/main.cpp \
            src/skyscraper.cpp \
@@ -119,4 +134,16 @@ SOURCES += src/main.cpp \
            src/fxrotate.cpp \
            src/fxscanlines.cpp \
            src/nametools.cpp \
-           src/queue.cpp
+           src/queue.cpp \
+           src/zipreader.cpp \
+           src/checksumtools.cpp \
+           src/disktools.cpp \
+           src/hashworker.cpp \
+           src/ratelimiter.cpp \
+           src/threadgovernor.cpp \
+           src/batch.cpp \
+           src/daemon.cpp \
+           src/fakescraper.cpp \
+           src/videoworker.cpp \
+           src/memoryguard.cpp \
+           src/entryspill.cpp
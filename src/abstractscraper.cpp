@@ -27,6 +27,7 @@
 #include "platform.h"
 #include "nametools.h"
 #include "strtools.h"
+#include "ratelimiter.h"
 
 #include <QRegularExpression>
 #include <QDomDocument>
@@ -131,6 +132,7 @@ void AbstractScraper::getGameData(GameEntry &game)
       ;
     }
   }
+  waitForMedia();
 }
 
 void AbstractScraper::getDescription(GameEntry &game)
@@ -287,12 +289,13 @@ void AbstractScraper::getCover(GameEntry &game)
   if(coverUrl.left(4) != "http") {
     coverUrl.prepend(baseUrl + (coverUrl.left(1) == "/"?"":"/"));
   }
-  manager.request(coverUrl);
-  q.exec();
-  QImage image;
-  if(image.loadFromData(manager.getData())) {
-    game.coverData = image;
-  }
+  fetchMedia(coverUrl, [&game](const NetReply &reply) -> bool {
+      QImage image;
+      if(reply.error == QNetworkReply::NoError && image.loadFromData(reply.data)) {
+	game.coverData = image;
+      }
+      return true;
+    });
 }
 
 void AbstractScraper::getScreenshot(GameEntry &game)
@@ -312,12 +315,13 @@ void AbstractScraper::getScreenshot(GameEntry &game)
     if(screenshotUrl.left(4) != "http") {
       screenshotUrl.prepend(baseUrl + (screenshotUrl.left(1) == "/"?"":"/"));
     }
-    manager.request(screenshotUrl);
-    q.exec();
-    QImage image;
-    if(image.loadFromData(manager.getData())) {
-      game.screenshotData = image;
-    }
+    fetchMedia(screenshotUrl, [&game](const NetReply &reply) -> bool {
+	QImage image;
+	if(reply.error == QNetworkReply::NoError && image.loadFromData(reply.data)) {
+	  game.screenshotData = image;
+	}
+	return true;
+      });
   }
 }
 
@@ -338,12 +342,13 @@ void AbstractScraper::getWheel(GameEntry &game)
   if(wheelUrl.left(4) != "http") {
     wheelUrl.prepend(baseUrl + (wheelUrl.left(1) == "/"?"":"/"));
   }
-  manager.request(wheelUrl);
-  q.exec();
-  QImage image;
-  if(image.loadFromData(manager.getData())) {
-    game.wheelData = image;
-  }
+  fetchMedia(wheelUrl, [&game](const NetReply &reply) -> bool {
+      QImage image;
+      if(reply.error == QNetworkReply::NoError && image.loadFromData(reply.data)) {
+	game.wheelData = image;
+      }
+      return true;
+    });
 }
 
 void AbstractScraper::getMarquee(GameEntry &game)
@@ -363,12 +368,13 @@ void AbstractScraper::getMarquee(GameEntry &game)
   if(marqueeUrl.left(4) != "http") {
     marqueeUrl.prepend(baseUrl + (marqueeUrl.left(1) == "/"?"":"/"));
   }
-  manager.request(marqueeUrl);
-  q.exec();
-  QImage image;
-  if(image.loadFromData(manager.getData())) {
-    game.marqueeData = image;
-  }
+  fetchMedia(marqueeUrl, [&game](const NetReply &reply) -> bool {
+      QImage image;
+      if(reply.error == QNetworkReply::NoError && image.loadFromData(reply.data)) {
+	game.marqueeData = image;
+      }
+      return true;
+    });
 }
 
 void AbstractScraper::getVideo(GameEntry &game)
@@ -388,10 +394,73 @@ void AbstractScraper::getVideo(GameEntry &game)
   if(videoUrl.left(4) != "http") {
     videoUrl.prepend(baseUrl + (videoUrl.left(1) == "/"?"":"/"));
   }
-  manager.request(videoUrl);
-  q.exec();
-  game.videoData = manager.getData();
-  game.videoFormat = videoUrl.right(3);
+  fetchMedia(videoUrl, [&game, videoUrl](const NetReply &reply) -> bool {
+      // Aborted downloads would leave a truncated video in the cache
+      if(reply.error != QNetworkReply::NoError) {
+	return true;
+      }
+      game.videoData = reply.data;
+      game.videoFormat = videoUrl.right(3);
+      return true;
+    }, 0, NET_VIDEO);
+}
+
+void AbstractScraper::fetchMedia(const QString &url,
+				 std::function<bool(const NetReply &reply)> handler,
+				 const int &retries, const int &reqClass)
+{
+  MediaRequest request;
+  request.url = url;
+  request.handler = handler;
+  request.retries = retries;
+  request.reqClass = reqClass;
+  request.limited = limitMedia;
+  if(reqClass == NET_VIDEO && deferVideos) {
+    videoRequests.append(request);
+    return;
+  }
+  if(inMediaHandler) {
+    // Don't wait for the rate limit from inside a handler, leave it for waitForMedia()
+    mediaRequests.append(request);
+    return;
+  }
+  sendMedia(request);
+}
+
+void AbstractScraper::sendMedia(const MediaRequest &request)
+{
+  if(request.limited) {
+    RateLimiter::acquire(config->scraper);
+  }
+  manager.requestAsync(request.url, [this, request](const NetReply &reply) {
+      inMediaHandler = true;
+      if(!request.handler(reply) && request.retries > 0) {
+	MediaRequest retry = request;
+	retry.retries--;
+	mediaRequests.append(retry);
+      }
+      inMediaHandler = false;
+    }, "", "", "", request.reqClass);
+}
+
+QList<MediaRequest> AbstractScraper::takeVideoRequests()
+{
+  QList<MediaRequest> requests = videoRequests;
+  videoRequests.clear();
+  return requests;
+}
+
+void AbstractScraper::waitForMedia()
+{
+  manager.waitForAll();
+  while(!mediaRequests.isEmpty()) {
+    QList<MediaRequest> requests = mediaRequests;
+    mediaRequests.clear();
+    foreach(MediaRequest request, requests) {
+      sendMedia(request);
+    }
+    manager.waitForAll();
+  }
 }
 
 void AbstractScraper::nomNom(const QString nom, bool including)
@@ -34,6 +34,17 @@
 #include "netcomm.h"
 #include "gameentry.h"
 #include "settings.h"
+#include "checksumtools.h"
+
+struct MediaRequest {
+  QString url = "";
+  // Returns false if the reply wasn't usable and the request should be retried
+  std::function<bool(const NetReply &reply)> handler;
+  int retries = 0;
+  int reqClass = NET_DEFAULT;
+  // Counts towards the module's request limit
+  bool limited = false;
+};
 
 class AbstractScraper : public QObject
 {
@@ -50,9 +61,25 @@ public:
   //void setConfig(Settings *config);
 
   int reqRemaining = -1;
+
+  // When set, videos aren't downloaded by getGameData(). Their requests are kept instead, so
+  // they can be handed to a video thread with takeVideoRequests()
+  bool deferVideos = false;
+  QList<MediaRequest> takeVideoRequests();
+  // Checksums of the file given to runPasses(), if they were already calculated by the hash
+  // workers. Modules that identify roms by their data use these instead of reading the file again
+  RomChecksums checksums;
+  // Media is downloaded in parallel. fetchMedia() sends the request right away and calls the
+  // handler when the reply arrives. The handlers write to the GameEntry given to getGameData(),
+  // so this must be called before that entry goes out of scope. ScraperWorker does so after
+  // every getGameData() call, so modules overriding it can't leave replies behind
+  void waitForMedia();
   
 protected:
   Settings *config;
+  // Set by modules that serve media from their api, so media downloads count towards the
+  // request limit. Media from plain web servers isn't limited
+  bool limitMedia = false;
 
   virtual void getSearchResults(QList<GameEntry> &gameEntries, QString searchName,
 				QString platform);
@@ -70,6 +97,9 @@ protected:
   virtual void getMarquee(GameEntry &game);
   virtual void getVideo(GameEntry &game);
 
+  void fetchMedia(const QString &url, std::function<bool(const NetReply &reply)> handler,
+		  const int &retries = 0, const int &reqClass = NET_DEFAULT);
+
   virtual void nomNom(const QString nom, bool including = true);
 
   virtual bool platformMatch(QString found, QString platform);
@@ -126,6 +156,13 @@ protected:
   NetComm manager;
   QEventLoop q; // Event loop for use when waiting for data from NetComm.
 
+private:
+  void sendMedia(const MediaRequest &request);
+  // Requests that are retried or made from within a handler are sent by waitForMedia()
+  QList<MediaRequest> mediaRequests;
+  QList<MediaRequest> videoRequests;
+  bool inMediaHandler = false;
+
 };
 
 #endif // ABSTRACTSCRAPER_H
@@ -27,6 +27,7 @@
 
 #include "arcadedb.h"
 #include "strtools.h"
+#include "ratelimiter.h"
 
 ArcadeDB::ArcadeDB(Settings *config) : AbstractScraper(config)
 {
@@ -50,6 +51,7 @@ ArcadeDB::ArcadeDB(Settings *config) : AbstractScraper(config)
 void ArcadeDB::getSearchResults(QList<GameEntry> &gameEntries,
 				QString searchName, QString platform)
 {
+  RateLimiter::acquire(config->scraper);
   manager.request(searchUrlPre + searchName);
   q.exec();
   data = manager.getData();
@@ -120,6 +122,7 @@ void ArcadeDB::getGameData(GameEntry &game)
       ;
     }
   }
+  waitForMedia();
 }
 
 void ArcadeDB::getReleaseDate(GameEntry &game)
@@ -152,56 +155,63 @@ void ArcadeDB::getDescription(GameEntry &game)
 
 void ArcadeDB::getCover(GameEntry &game)
 {
-  manager.request(jsonObj.value("url_image_flyer").toString());
-  q.exec();
-  {
-    QImage image;
-    if(image.loadFromData(manager.getData())) {
-      game.coverData = image;
-      return;
-    }
-  }
-  manager.request(jsonObj.value("url_image_title").toString());
-  q.exec();
-  {
-    QImage image;
-    if(image.loadFromData(manager.getData())) {
-      game.coverData = image;
-      return;
-    }
-  }
+  QString titleUrl = jsonObj.value("url_image_title").toString();
+  fetchMedia(jsonObj.value("url_image_flyer").toString(),
+	     [this, &game, titleUrl](const NetReply &reply) -> bool {
+	       QImage image;
+	       if(reply.error == QNetworkReply::NoError && image.loadFromData(reply.data)) {
+		 game.coverData = image;
+	       } else {
+		 // No flyer, use the title screen instead
+		 fetchMedia(titleUrl, [&game](const NetReply &reply) -> bool {
+		     QImage image;
+		     if(reply.error == QNetworkReply::NoError && image.loadFromData(reply.data)) {
+		       game.coverData = image;
+		     }
+		     return true;
+		   });
+	       }
+	       return true;
+	     });
 }
 
 void ArcadeDB::getScreenshot(GameEntry &game)
 {
-  manager.request(jsonObj.value("url_image_ingame").toString());
-  q.exec();
-  QImage image;
-  if(image.loadFromData(manager.getData())) {
-    game.screenshotData = image;
-  }
+  fetchMedia(jsonObj.value("url_image_ingame").toString(), [&game](const NetReply &reply) -> bool {
+      QImage image;
+      if(reply.error == QNetworkReply::NoError && image.loadFromData(reply.data)) {
+	game.screenshotData = image;
+      }
+      return true;
+    });
 }
 
 void ArcadeDB::getMarquee(GameEntry &game)
 {
-  manager.request(jsonObj.value("url_image_marquee").toString());
-  q.exec();
-  QImage image;
-  if(image.loadFromData(manager.getData())) {
-    game.marqueeData = image;
-  }
+  fetchMedia(jsonObj.value("url_image_marquee").toString(), [&game](const NetReply &reply) -> bool {
+      QImage image;
+      if(reply.error == QNetworkReply::NoError && image.loadFromData(reply.data)) {
+	game.marqueeData = image;
+      }
+      return true;
+    });
 }
 
 void ArcadeDB::getVideo(GameEntry &game)
 {
-  manager.request(jsonObj.value("url_video_shortplay").toString());
-  q.exec();
-  game.videoData = manager.getData();
-  if(game.videoData.length() > (1024 * 500)) {
-    game.videoFormat = "mp4";
-  } else {
-    game.videoData = "";
-  }
+  fetchMedia(jsonObj.value("url_video_shortplay").toString(), [&game](const NetReply &reply) -> bool {
+      // Aborted downloads would leave a truncated video in the cache
+      if(reply.error != QNetworkReply::NoError) {
+	return true;
+      }
+      game.videoData = reply.data;
+      if(game.videoData.length() > (1024 * 500)) {
+	game.videoFormat = "mp4";
+      } else {
+	game.videoData = "";
+      }
+      return true;
+    }, 0, NET_VIDEO);
 }
 
 QList<QString> ArcadeDB::getSearchNames(const QFileInfo &info)
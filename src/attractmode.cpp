@@ -75,7 +75,7 @@ bool AttractMode::loadOldGameList(const QString &gameListFileString)
   return false;
 }
 
-bool AttractMode::skipExisting(QList<GameEntry> &gameEntries, QSharedPointer<Queue> queue)
+bool AttractMode::skipExisting(QList<GameEntry> &gameEntries, QList<QFileInfo> &queue)
 {
   gameEntries = oldEntries;
 
@@ -87,9 +87,9 @@ bool AttractMode::skipExisting(QList<GameEntry> &gameEntries, QSharedPointer<Que
       printf(".");
       fflush(stdout);
     }
-    for(int b = 0; b < queue->length(); ++b) {
-      if(gameEntries.at(a).baseName == queue->at(b).completeBaseName()) {
-	queue->removeAt(b);
+    for(int b = 0; b < queue.length(); ++b) {
+      if(gameEntries.at(a).baseName == queue.at(b).completeBaseName()) {
+	queue.removeAt(b);
 	// We assume baseName is unique, so break after getting first hit
 	break;
       }
@@ -35,7 +35,7 @@ class AttractMode : public AbstractFrontend
 public:
   AttractMode();
   void checkReqs() override;
-  bool skipExisting(QList<GameEntry> &gameEntries, QSharedPointer<Queue> queue) override;
+  bool skipExisting(QList<GameEntry> &gameEntries, QList<QFileInfo> &queue) override;
   void assembleList(QString &finalOutput, const QList<GameEntry> &gameEntries) override;
   bool canSkip() override;
   bool loadOldGameList(const QString &gameListFileString) override;
@@ -0,0 +1,91 @@
+/***************************************************************************
+ *            batch.cpp
+ *
+ *  Sun Oct 18 15:51:38 UTC 2026
+ ****************************************************************************/
+/*
+ *  This file is part of skyscraper.
+ *
+ *  skyscraper is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  skyscraper is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with skyscraper; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA.
+ */
+
+#include <QTimer>
+
+#include "batch.h"
+
+Batch::Batch(const QCommandLineParser &parser, const QString &currentDir,
+	     const QList<QString> &platforms) : parser(parser)
+{
+  this->currentDir = currentDir;
+  this->platforms = platforms;
+  total = platforms.length();
+}
+
+void Batch::run()
+{
+  printf("\033[1;34m---- Running batch of %d platforms ----\033[0m\n\n", total);
+  startNext();
+}
+
+void Batch::startNext()
+{
+  if(platforms.isEmpty() || running.length() >= BATCHOVERLAP) {
+    return;
+  }
+  QString platform = platforms.takeFirst();
+  printf("\033[1;34m---- Starting platform '%s' (%d of %d) ----\033[0m\n", platform.toStdString().c_str(), total - platforms.length(), total);
+  Skyscraper *skyscraper = new Skyscraper(parser, currentDir, platform);
+  running.append(skyscraper);
+  connect(skyscraper, &Skyscraper::hashingDone, this, &Batch::startNext);
+  connect(skyscraper, &Skyscraper::finished, this, &Batch::platformDone);
+  QTimer::singleShot(0, skyscraper, SLOT(run()));
+}
+
+void Batch::platformDone()
+{
+  Skyscraper *skyscraper = qobject_cast<Skyscraper *>(sender());
+  running.removeOne(skyscraper);
+  skyscraper->deleteLater();
+  done++;
+  printf("\033[1;34m---- Done with %d of %d platforms ----\033[0m\n\n", done, total);
+  if(running.isEmpty()) {
+    if(platforms.isEmpty()) {
+      emit finished();
+    } else {
+      startNext();
+    }
+  }
+}
+
+bool Batch::threadsRunning()
+{
+  foreach(Skyscraper *skyscraper, running) {
+    if(skyscraper->threadsRunning) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Drops the platforms that haven't been started yet and stops the running ones nicely
+void Batch::stopRun()
+{
+  platforms.clear();
+  foreach(Skyscraper *skyscraper, running) {
+    if(skyscraper->threadsRunning) {
+      skyscraper->stopRun();
+    }
+  }
+}
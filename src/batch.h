@@ -0,0 +1,71 @@
+/***************************************************************************
+ *            batch.h
+ *
+ *  Sun Oct 18 15:51:38 UTC 2026
+ ****************************************************************************/
+/*
+ *  This file is part of skyscraper.
+ *
+ *  skyscraper is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  skyscraper is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with skyscraper; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA.
+ */
+
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <QObject>
+#include <QList>
+#include <QString>
+#include <QCommandLineParser>
+
+#include "skyscraper.h"
+
+// Maximum number of platforms running at the same time in batch mode
+#define BATCHOVERLAP 2
+
+// Runs several platforms in one process when more than one is given with '-p'. Files, maps and
+// module checks are only loaded once and the rate limits are shared by all platforms. The next
+// platform is started as soon as the current one is done checksumming, so its first requests
+// overlap with the last games of the previous platform
+class Batch : public QObject
+{
+  Q_OBJECT
+
+public:
+  Batch(const QCommandLineParser &parser, const QString &currentDir,
+	const QList<QString> &platforms);
+  bool threadsRunning();
+  void stopRun();
+
+public slots:
+  void run();
+
+signals:
+  void finished();
+
+private slots:
+  void startNext();
+  void platformDone();
+
+private:
+  const QCommandLineParser &parser;
+  QString currentDir;
+  QList<QString> platforms;
+  QList<Skyscraper *> running;
+  int total;
+  int done = 0;
+
+};
+
+#endif // BATCH_H
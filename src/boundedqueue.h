@@ -0,0 +1,105 @@
+/***************************************************************************
+ *            boundedqueue.h
+ *
+ *  Sun Oct 18 15:25:32 UTC 2026
+ ****************************************************************************/
+/*
+ *  This file is part of skyscraper.
+ *
+ *  skyscraper is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  skyscraper is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with skyscraper; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA.
+ */
+
+#ifndef BOUNDEDQUEUE_H
+#define BOUNDEDQUEUE_H
+
+#include <QList>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QWaitCondition>
+
+// Connects the stages of a scraping run. Producers block when the queue is full, consumers
+// block when it is empty until all producers have called producerDone()
+template <typename T>
+class BoundedQueue
+{
+public:
+  BoundedQueue(const int &capacity)
+  {
+    this->capacity = capacity;
+  }
+
+  void setProducers(const int &producers)
+  {
+    QMutexLocker locker(&mutex);
+    this->producers = producers;
+  }
+
+  void push(const T &item)
+  {
+    QMutexLocker locker(&mutex);
+    while(items.length() >= capacity && !aborted) {
+      notFull.wait(&mutex);
+    }
+    if(aborted) {
+      return;
+    }
+    items.append(item);
+    notEmpty.wakeOne();
+  }
+
+  bool pop(T &item)
+  {
+    QMutexLocker locker(&mutex);
+    while(items.isEmpty()) {
+      if(producers <= 0 || aborted) {
+	return false;
+      }
+      notEmpty.wait(&mutex);
+    }
+    item = items.takeFirst();
+    notFull.wakeOne();
+    return true;
+  }
+
+  void producerDone()
+  {
+    QMutexLocker locker(&mutex);
+    producers--;
+    if(producers <= 0) {
+      notEmpty.wakeAll();
+    }
+  }
+
+  void abort()
+  {
+    QMutexLocker locker(&mutex);
+    aborted = true;
+    items.clear();
+    notFull.wakeAll();
+    notEmpty.wakeAll();
+  }
+
+private:
+  QMutex mutex;
+  QWaitCondition notFull;
+  QWaitCondition notEmpty;
+  QList<T> items;
+  int capacity;
+  int producers = 0;
+  bool aborted = false;
+
+};
+
+#endif // BOUNDEDQUEUE_H
@@ -24,9 +24,11 @@
  */
 
 #include <iostream>
+#include <algorithm>
 
 #include <QFile>
 #include <QDir>
+#include <QHash>
 #include <QXmlStreamReader>
 #include <QXmlStreamAttributes>
 #include <QDateTime>
@@ -206,8 +208,8 @@ void Cache::editResources(QSharedPointer<Queue> queue)
 {
   int queueLength = queue->length();
   printf("\033[1;33mEntering resource cache editing mode! This mode allows you to edit textual resources for your files. To add media resources use the 'import' scraping module instead.\nNote that you can provide one or more file names on command line to edit resources for just those specific files. You can also use the '--startat' and '--endat' command line options to narrow down the span of the roms you wish to edit. Otherwise Skyscraper will edit ALL files found in the input folder one by one.\033[0m\n\n\033[1;31mNote! All changes are done in memory. If you ctrl+c the process at ANY time, all of your changes will be undone! Instead, use the 'q' option as shown, which will save all of your changes back to disk before exiting.\033[0m\n\n");
-  while(queue->hasEntry()) {
-    QFileInfo info = queue->takeEntry();
+  QFileInfo info;
+  while(queue->takeEntry(info)) {
     QString sha1 = NameTools::getSha1(info);
     bool doneEdit = false;
     printPriorities(sha1);
@@ -495,7 +497,7 @@ void Cache::editResources(QSharedPointer<Queue> queue)
 	  printf("No resources of type '\033[1;32m%s\033[0m' found, cancelling...\n\n", typeInput.c_str());
  	}
       } else if(userInput == "q") {
-	queue->clear();
+	queue->clearAll();
 	doneEdit = true;
 	continue;
       }
@@ -1002,50 +1004,56 @@ void Cache::merge(Cache &mergeCache, bool overwrite, const QString &mergeCacheFo
   int resUpdated = 0;
   int resMerged = 0;
 
+  // Look up the existing resources by sha1, type and source instead of comparing each merged
+  // resource to all of them. This keeps merging several large shard caches fast
+  QHash<QString, int> existing;
+  for(int a = 0; a < resources.length(); ++a) {
+    existing.insert(resources.at(a).sha1 + resources.at(a).type + resources.at(a).source, a);
+  }
+  QList<int> removed;
+
   foreach(Resource mergeResource, mergeResources) {
-    bool resExists = false;
-    // This type of iterator ensures we can delete items while iterating
-    QMutableListIterator<Resource> it(resources);
-    while(it.hasNext()) {
-      Resource res = it.next();
-      if(res.sha1 == mergeResource.sha1 &&
-	 res.type == mergeResource.type &&
-	 res.source == mergeResource.source) {
-	if(overwrite) {
-	  if(res.type == "cover" || res.type == "screenshot" ||
-	     res.type == "wheel" || res.type == "marquee" ||
-	     res.type == "video") {
-	    if(!QFile::remove(cacheDir.absolutePath() + "/" + res.value)) {
-	      printf("Couldn't remove media file '%s' for updating, skipping...\n", res.value.toStdString().c_str());
-	      continue;
-	    }
-	    
-	  }
-	  it.remove();
-	} else {
-	  resExists = true;
-	  break;
-	}
+    QString key = mergeResource.sha1 + mergeResource.type + mergeResource.source;
+    bool resExists = existing.contains(key);
+    if(resExists) {
+      if(!overwrite) {
+	continue;
       }
-    }
-    if(!resExists) {
-      if(mergeResource.type == "cover" || mergeResource.type == "screenshot" ||
-	 mergeResource.type == "wheel" || mergeResource.type == "marquee" ||
-	 mergeResource.type == "video") {
-	cacheDir.mkpath(QFileInfo(cacheDir.absolutePath() + "/" + mergeResource.value).absolutePath());
-	if(!QFile::copy(mergeCacheDir.absolutePath() + "/" + mergeResource.value,
-			cacheDir.absolutePath() + "/" + mergeResource.value)) {
-	  printf("Couldn't copy media file '%s', skipping...\n",  mergeResource.value.toStdString().c_str());
+      int index = existing.value(key);
+      Resource res = resources.at(index);
+      if(res.type == "cover" || res.type == "screenshot" ||
+	 res.type == "wheel" || res.type == "marquee" ||
+	 res.type == "video") {
+	if(!QFile::remove(cacheDir.absolutePath() + "/" + res.value)) {
+	  printf("Couldn't remove media file '%s' for updating, skipping...\n", res.value.toStdString().c_str());
 	  continue;
 	}
       }
-      if(overwrite) {
-	resUpdated++;
-      } else {
-	resMerged++;
+      removed.append(index);
+      existing.remove(key);
+    }
+    if(mergeResource.type == "cover" || mergeResource.type == "screenshot" ||
+       mergeResource.type == "wheel" || mergeResource.type == "marquee" ||
+       mergeResource.type == "video") {
+      cacheDir.mkpath(QFileInfo(cacheDir.absolutePath() + "/" + mergeResource.value).absolutePath());
+      if(!QFile::copy(mergeCacheDir.absolutePath() + "/" + mergeResource.value,
+		      cacheDir.absolutePath() + "/" + mergeResource.value)) {
+	printf("Couldn't copy media file '%s', skipping...\n",  mergeResource.value.toStdString().c_str());
+	continue;
       }
-      resources.append(mergeResource);
     }
+    if(resExists) {
+      resUpdated++;
+    } else {
+      resMerged++;
+    }
+    resources.append(mergeResource);
+    existing.insert(key, resources.length() - 1);
+  }
+  // Remove the replaced resources from the back, so the remaining indexes stay valid
+  std::sort(removed.begin(), removed.end());
+  for(int a = removed.length() - 1; a >= 0; --a) {
+    resources.removeAt(removed.at(a));
   }
   printf("Successfully updated %d resource(s) in cache!\n", resUpdated);
   printf("Successfully merged %d new resource(s) into cache!\n\n", resMerged);
@@ -0,0 +1,190 @@
+/***************************************************************************
+ *            checksumtools.cpp
+ *
+ *  Sun Oct 18 15:25:32 UTC 2026
+ ****************************************************************************/
+/*
+ *  This file is part of skyscraper.
+ *
+ *  skyscraper is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  skyscraper is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with skyscraper; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA.
+ */
+
+#include <QFile>
+#include <QProcess>
+#include <QCryptographicHash>
+
+#include "checksumtools.h"
+#include "crc32.h"
+#include "zipreader.h"
+
+// Calculates the crc, md5 and sha1 of the file. With 'unpack' set, single file zip and 7z
+// archives are checksummed by their contents instead
+RomChecksums ChecksumTools::getChecksums(const QFileInfo &info, const bool &unpackSet)
+{
+  RomChecksums checksums;
+  QCryptographicHash md5(QCryptographicHash::Md5);
+  QCryptographicHash sha1(QCryptographicHash::Sha1);
+  Crc32 crc;
+  crc.initInstance(1);
+
+  bool unpack = unpackSet;
+  qint64 romSize = info.size();
+
+  if(unpack) {
+    bool unpacked = false;
+    // Zip files are decompressed in-process and streamed directly into the checksums
+    if(info.suffix() == "zip") {
+      ZipReader zip(info.absoluteFilePath());
+      if(zip.readCentralDirectory()) {
+	QList<ZipEntry> zipEntries = zip.getEntries();
+	if(zipEntries.length() != 1) {
+	  printf("Compressed file contains more than 1 file, falling back...\n");
+	  unpack = false;
+	} else if(zip.canDecompress(zipEntries.first())) {
+	  if(zip.decompress(zipEntries.first(), [&](const char *data, int len) {
+		md5.addData(data, len);
+		sha1.addData(data, len);
+		crc.pushData(1, (char *)data, len);
+	      })) {
+	    romSize = zipEntries.first().uncompressedSize;
+	    unpacked = true;
+	  } else {
+	    // Reset checksums since they might have received partial data
+	    md5.reset();
+	    sha1.reset();
+	    crc.initInstance(1);
+	  }
+	}
+      }
+    }
+    // Use '7z' for the formats we can't decode ourselves
+    if(unpack && !unpacked) {
+      // Size limit for "unpack" is set to 80 megs to ensure the pi doesn't run out of memory
+      if((info.suffix() == "7z" || info.suffix() == "zip") && info.size() < 81920000) {
+	// For 7z (7z, zip) unpacked file reading
+	{
+	  QProcess decProc;
+	  decProc.setReadChannel(QProcess::StandardOutput);
+
+	  decProc.start("7z l -so \"" + info.absoluteFilePath() + "\"");
+	  if(decProc.waitForFinished(30000)) {
+	    if(decProc.exitStatus() != QProcess::NormalExit) {
+	      printf("Getting file list from compressed file failed, falling back...\n");
+	      unpack = false;
+	    } else if(!decProc.readAllStandardOutput().contains(" 1 files")) {
+	      printf("Compressed file contains more than 1 file, falling back...\n");
+	      unpack = false;
+	    }
+	  } else {
+	    printf("Getting file list from compressed file timed out or failed, falling back...\n");
+	    unpack = false;
+	  }
+	}
+
+	if(unpack) {
+	  QProcess decProc;
+	  decProc.setReadChannel(QProcess::StandardOutput);
+
+	  decProc.start("7z x -so \"" + info.absoluteFilePath() + "\"");
+	  if(decProc.waitForFinished(30000)) {
+	    if(decProc.exitStatus() == QProcess::NormalExit) {
+	      QByteArray allData = decProc.readAllStandardOutput();
+	      md5.addData(allData);
+	      sha1.addData(allData);
+	      crc.pushData(1, allData.data(), allData.length());
+	      romSize = allData.length();
+	    } else {
+	      printf("Something went wrong when decompressing file to stdout, falling back...\n");
+	      unpack = false;
+	    }
+	  } else {
+	    printf("Decompression process timed out or failed, falling back...\n");
+	    unpack = false;
+	  }
+	}
+      } else {
+	printf("File either not a compressed file or exceeds 80 meg size limit, falling back...\n");
+	unpack = false;
+      }
+    }
+  }
+
+  if(!unpack) {
+    // For normal file reading
+    QFile romFile(info.absoluteFilePath());
+    if(!romFile.open(QIODevice::ReadOnly)) {
+      return checksums;
+    }
+    while(!romFile.atEnd()) {
+      QByteArray dataSeg = romFile.read(65536);
+      md5.addData(dataSeg);
+      sha1.addData(dataSeg);
+      crc.pushData(1, dataSeg.data(), dataSeg.length());
+    }
+    romFile.close();
+  }
+
+  checksums.valid = true;
+  checksums.unpacked = unpack;
+  checksums.crc = QString::number(crc.releaseInstance(1), 16).rightJustified(8, '0');
+  checksums.md5 = toHex(md5.result(), 32);
+  checksums.sha1 = toHex(sha1.result(), 40);
+  checksums.size = romSize;
+  return checksums;
+}
+
+// Only calculates the crc. Zip files store the crc and size of each contained file in the
+// central directory, so for single file zips we don't need to read or unpack the file data at all
+RomChecksums ChecksumTools::getCrc(const QFileInfo &info)
+{
+  RomChecksums checksums;
+  quint32 crcValue = 0;
+  qint64 romSize = info.size();
+
+  bool fromHeader = false;
+  if(info.suffix() == "zip") {
+    ZipReader zip(info.absoluteFilePath());
+    if(zip.readCentralDirectory() && zip.getEntries().length() == 1) {
+      crcValue = zip.getEntries().first().crc;
+      romSize = zip.getEntries().first().uncompressedSize;
+      fromHeader = true;
+    }
+  }
+  if(!fromHeader) {
+    Crc32 crc;
+    crc.initInstance(1);
+    QFile romFile(info.absoluteFilePath());
+    if(!romFile.open(QIODevice::ReadOnly)) {
+      return checksums;
+    }
+    while(!romFile.atEnd()) {
+      QByteArray dataSeg = romFile.read(65536);
+      crc.pushData(1, dataSeg.data(), dataSeg.length());
+    }
+    romFile.close();
+    crcValue = crc.releaseInstance(1);
+  }
+
+  checksums.valid = true;
+  checksums.unpacked = fromHeader;
+  checksums.crc = QString::number(crcValue, 16).rightJustified(8, '0');
+  checksums.size = romSize;
+  return checksums;
+}
+
+QString ChecksumTools::toHex(const QByteArray &hash, const int &length)
+{
+  return QString(hash.toHex()).rightJustified(length, '0');
+}
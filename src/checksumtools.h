@@ -0,0 +1,53 @@
+/***************************************************************************
+ *            checksumtools.h
+ *
+ *  Sun Oct 18 15:25:32 UTC 2026
+ ****************************************************************************/
+/*
+ *  This file is part of skyscraper.
+ *
+ *  skyscraper is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  skyscraper is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with skyscraper; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA.
+ */
+
+#ifndef CHECKSUMTOOLS_H
+#define CHECKSUMTOOLS_H
+
+#include <QFileInfo>
+#include <QString>
+
+// Checksums of a rom's contents as used by the modules that identify roms by their data. All
+// of them are lowercase hex. 'md5' and 'sha1' are empty when only the crc was calculated
+struct RomChecksums {
+  bool valid = false;
+  // True if the checksums are of the contents of a compressed file rather than the file itself
+  bool unpacked = false;
+  QString crc = "";
+  QString md5 = "";
+  QString sha1 = "";
+  qint64 size = 0;
+};
+
+class ChecksumTools
+{
+public:
+  static RomChecksums getChecksums(const QFileInfo &info, const bool &unpack);
+  static RomChecksums getCrc(const QFileInfo &info);
+
+private:
+  static QString toHex(const QByteArray &hash, const int &length);
+
+};
+
+#endif // CHECKSUMTOOLS_H
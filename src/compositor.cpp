@@ -49,6 +49,22 @@
 #include "fxrotate.h"
 #include "fxscanlines.h"
 
+CompositorJob::CompositorJob(Compositor *compositor, const GameEntry &game,
+			     const QString &completeBaseName,
+			     std::function<void(GameEntry &game)> jobDone)
+{
+  this->compositor = compositor;
+  this->game = game;
+  this->completeBaseName = completeBaseName;
+  this->jobDone = jobDone;
+}
+
+void CompositorJob::run()
+{
+  compositor->saveAll(game, completeBaseName);
+  jobDone(game);
+}
+
 Compositor::Compositor(Settings *config)
 {
   this->config = config;
@@ -364,7 +380,7 @@ void Compositor::processChildLayers(GameEntry &game, Layer &layer)
       } else if(thisLayer.resource == "marquee") {
 	thisLayer.setCanvas(game.marqueeData);
       } else {
-	thisLayer.setCanvas(config->resources[thisLayer.resource]);
+	thisLayer.setCanvas(config->resources.value(thisLayer.resource));
       }
 	  
       // If no meaningful canvas could be created, stop processing this layer branch entirely
@@ -26,8 +26,11 @@
 #ifndef COMPOSITOR_H
 #define COMPOSITOR_H
 
+#include <functional>
+
 #include <QImage>
 #include <QXmlStreamReader>
+#include <QRunnable>
 
 #include "settings.h"
 #include "gameentry.h"
@@ -50,4 +53,20 @@ private:
   
 };
 
+// Runs 'saveAll' for a single game on a QThreadPool so the scraping thread can move on
+class CompositorJob : public QRunnable
+{
+public:
+  CompositorJob(Compositor *compositor, const GameEntry &game, const QString &completeBaseName,
+		std::function<void(GameEntry &game)> jobDone);
+  void run() override;
+
+private:
+  Compositor *compositor;
+  GameEntry game;
+  QString completeBaseName;
+  std::function<void(GameEntry &game)> jobDone;
+
+};
+
 #endif // COMPOSITOR_H
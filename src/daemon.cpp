@@ -0,0 +1,265 @@
+/***************************************************************************
+ *            daemon.cpp
+ *
+ *  Sun Oct 18 15:59:49 UTC 2026
+ ****************************************************************************/
+/*
+ *  This file is part of skyscraper.
+ *
+ *  skyscraper is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  skyscraper is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with skyscraper; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA.
+ */
+
+#include <QDir>
+#include <QFileInfo>
+#include <QPointer>
+#include <QTimer>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QJsonParseError>
+
+#include "daemon.h"
+#include "strtools.h"
+#include "platform.h"
+
+Daemon::Daemon(const QCommandLineParser &parser, const QString &currentDir) : parser(parser)
+{
+  this->currentDir = currentDir;
+}
+
+Daemon::~Daemon()
+{
+  qDeleteAll(contexts);
+}
+
+void Daemon::run()
+{
+  printf("%s", StrTools::getVersionHeader().toStdString().c_str());
+
+  // Remove the socket left behind if a previous daemon didn't quit nicely
+  QLocalServer::removeServer(QDir::current().absoluteFilePath(DAEMONSOCKET));
+  connect(&server, &QLocalServer::newConnection, this, &Daemon::newConnection);
+  if(!server.listen(QDir::current().absoluteFilePath(DAEMONSOCKET))) {
+    printf("Couldn't listen on socket '%s': %s\nNow exiting...\n", QDir::current().absoluteFilePath(DAEMONSOCKET).toStdString().c_str(), server.errorString().toStdString().c_str());
+    exit(1);
+  }
+  printf("\033[1;34m---- Daemon listening on '%s' ----\033[0m\n\n", server.fullServerName().toStdString().c_str());
+}
+
+void Daemon::newConnection()
+{
+  while(server.hasPendingConnections()) {
+    QLocalSocket *socket = server.nextPendingConnection();
+    connect(socket, &QLocalSocket::readyRead, this, &Daemon::readRequests);
+    connect(socket, &QLocalSocket::disconnected, socket, &QLocalSocket::deleteLater);
+  }
+}
+
+void Daemon::readRequests()
+{
+  QLocalSocket *socket = qobject_cast<QLocalSocket *>(sender());
+  while(socket->canReadLine()) {
+    QByteArray line = socket->readLine().trimmed();
+    if(!line.isEmpty()) {
+      handleRequest(socket, line);
+    }
+  }
+}
+
+void Daemon::handleRequest(QLocalSocket *socket, const QByteArray &line)
+{
+  QJsonParseError parseError;
+  QJsonDocument jsonDoc = QJsonDocument::fromJson(line, &parseError);
+  if(parseError.error != QJsonParseError::NoError) {
+    sendError(socket, QJsonValue(), RPC_PARSEERROR, parseError.errorString());
+    return;
+  }
+  QJsonObject request = jsonDoc.object();
+  QJsonValue id = request.value("id");
+  if(request.value("jsonrpc").toString() != "2.0" || !request.value("method").isString()) {
+    sendError(socket, id, RPC_INVALIDREQUEST, "Not a JSON-RPC 2.0 request");
+    return;
+  }
+  if(shuttingDown) {
+    sendError(socket, id, RPC_SHUTTINGDOWN, "Daemon is shutting down");
+    return;
+  }
+  QString method = request.value("method").toString();
+  QJsonObject params = request.value("params").toObject();
+
+  if(method == "ping") {
+    QJsonObject result;
+    result.insert("version", VERSION);
+    result.insert("contexts", QJsonArray::fromStringList(contexts.keys()));
+    sendResult(socket, id, result);
+    return;
+  }
+  if(method == "shutdown") {
+    sendResult(socket, id, true);
+    socket->flush();
+    shutdown();
+    return;
+  }
+  if(method != "lookup" && method != "generate" && method != "scrape") {
+    sendError(socket, id, RPC_UNKNOWNMETHOD, "Unknown method '" + method + "'");
+    return;
+  }
+
+  // 'lookup' and 'generate' only use what is already in the cache
+  QString module = "cache";
+  if(method == "scrape") {
+    module = params.value("module").toString();
+  }
+  QString error;
+  Skyscraper *context = getContext(params.value("platform").toString(), module, error);
+  if(context == nullptr) {
+    sendError(socket, id, RPC_INVALIDPARAMS, error);
+    return;
+  }
+  QFileInfo info(params.value("file").toString());
+  if(info.isRelative()) {
+    info.setFile(currentDir + "/" + params.value("file").toString());
+  }
+  if(params.value("file").toString().isEmpty() || !info.isFile()) {
+    sendError(socket, id, RPC_INVALIDPARAMS, "File '" + params.value("file").toString() + "' doesn't exist");
+    return;
+  }
+
+  pending++;
+  // The client might be gone by the time the file is done
+  QPointer<QLocalSocket> client(socket);
+  context->serve(info, method == "generate", params.value("refresh").toBool(),
+		 [this, client, id](const GameEntry &entry) {
+		   if(!client.isNull()) {
+		     sendResult(client.data(), id, entryToJson(entry));
+		   }
+		   requestDone();
+		 });
+}
+
+Skyscraper *Daemon::getContext(const QString &platform, const QString &module,
+			       QString &error)
+{
+  if(!Platform::getPlatforms().contains(platform)) {
+    error = "Unsupported platform '" + platform + "'";
+    return nullptr;
+  }
+  if(module != "cache" && module != "openretro" && module != "thegamesdb" &&
+     module != "arcadedb" && module != "worldofspectrum" && module != "igdb" &&
+     module != "mobygames" && module != "screenscraper" && module != "esgamelist" &&
+     module != "import" && module != "fake") {
+    error = "Unsupported module '" + module + "'";
+    return nullptr;
+  }
+  QString key = platform + "/" + module;
+  if(!contexts.contains(key)) {
+    printf("\033[1;34m---- Setting up '%s' ----\033[0m\n", key.toStdString().c_str());
+    Skyscraper *context = new Skyscraper(parser, currentDir, platform, module, true);
+    if(!context->prepare()) {
+      delete context;
+      error = "Couldn't set up '" + key + "'";
+      return nullptr;
+    }
+    contexts[key] = context;
+  }
+  return contexts.value(key);
+}
+
+QJsonObject Daemon::entryToJson(const GameEntry &entry)
+{
+  QJsonObject result;
+  result.insert("path", entry.path);
+  result.insert("sha1", entry.sha1);
+  result.insert("found", entry.found);
+  result.insert("title", entry.title);
+  if(!entry.found) {
+    return result;
+  }
+  result.insert("platform", entry.platform);
+  result.insert("searchMatch", entry.searchMatch);
+  result.insert("description", entry.description);
+  result.insert("releaseDate", entry.releaseDate);
+  result.insert("developer", entry.developer);
+  result.insert("publisher", entry.publisher);
+  result.insert("players", entry.players);
+  result.insert("ages", entry.ages);
+  result.insert("tags", entry.tags);
+  result.insert("rating", entry.rating);
+  // Only set once the artwork has been composited by 'generate'
+  QJsonObject media;
+  if(!entry.coverFile.isEmpty())
+    media.insert("cover", entry.coverFile);
+  if(!entry.screenshotFile.isEmpty())
+    media.insert("screenshot", entry.screenshotFile);
+  if(!entry.wheelFile.isEmpty())
+    media.insert("wheel", entry.wheelFile);
+  if(!entry.marqueeFile.isEmpty())
+    media.insert("marquee", entry.marqueeFile);
+  if(!entry.videoFile.isEmpty() && !entry.videoFormat.isEmpty())
+    media.insert("video", entry.videoFile);
+  if(!media.isEmpty()) {
+    result.insert("media", media);
+  }
+  return result;
+}
+
+void Daemon::sendResult(QLocalSocket *socket, const QJsonValue &id, const QJsonValue &result)
+{
+  QJsonObject response;
+  response.insert("jsonrpc", "2.0");
+  response.insert("id", id);
+  response.insert("result", result);
+  socket->write(QJsonDocument(response).toJson(QJsonDocument::Compact) + "\n");
+}
+
+void Daemon::sendError(QLocalSocket *socket, const QJsonValue &id, const int &code,
+		       const QString &message)
+{
+  QJsonObject error;
+  error.insert("code", code);
+  error.insert("message", message);
+  QJsonObject response;
+  response.insert("jsonrpc", "2.0");
+  response.insert("id", id);
+  response.insert("error", error);
+  socket->write(QJsonDocument(response).toJson(QJsonDocument::Compact) + "\n");
+}
+
+void Daemon::requestDone()
+{
+  pending--;
+  if(shuttingDown && pending == 0) {
+    shutdown();
+  }
+}
+
+// Stops taking new requests. Once the pending ones are done the caches are written and the
+// daemon quits
+void Daemon::shutdown()
+{
+  if(!shuttingDown) {
+    shuttingDown = true;
+    server.close();
+    printf("Daemon is shutting down...\n");
+  }
+  if(pending > 0) {
+    return;
+  }
+  foreach(Skyscraper *context, contexts) {
+    context->flushCache();
+  }
+  QLocalServer::removeServer(QDir::current().absoluteFilePath(DAEMONSOCKET));
+  // Give the event loop a chance to send the last responses
+  QTimer::singleShot(0, this, &Daemon::finished);
+}
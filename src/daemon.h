@@ -0,0 +1,89 @@
+/***************************************************************************
+ *            daemon.h
+ *
+ *  Sun Oct 18 15:59:49 UTC 2026
+ ****************************************************************************/
+/*
+ *  This file is part of skyscraper.
+ *
+ *  skyscraper is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  skyscraper is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with skyscraper; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA.
+ */
+
+#ifndef DAEMON_H
+#define DAEMON_H
+
+#include <QObject>
+#include <QMap>
+#include <QString>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QCommandLineParser>
+
+#include "skyscraper.h"
+
+// Filename of the local socket in '~/.skyscraper'
+#define DAEMONSOCKET "skyscraper.sock"
+
+// JSON-RPC 2.0 error codes
+#define RPC_PARSEERROR -32700
+#define RPC_INVALIDREQUEST -32600
+#define RPC_UNKNOWNMETHOD -32601
+#define RPC_INVALIDPARAMS -32602
+#define RPC_SHUTTINGDOWN -32000
+
+// Keeps Skyscraper running and serves requests over a local socket using newline delimited
+// JSON-RPC 2.0. A Skyscraper instance is set up the first time a platform and module
+// combination is requested, and is then kept around with its cache, maps and artwork
+// definition in memory for the following requests
+class Daemon : public QObject
+{
+  Q_OBJECT
+
+public:
+  Daemon(const QCommandLineParser &parser, const QString &currentDir);
+  ~Daemon();
+  void shutdown();
+
+public slots:
+  void run();
+
+signals:
+  void finished();
+
+private slots:
+  void newConnection();
+  void readRequests();
+
+private:
+  void handleRequest(QLocalSocket *socket, const QByteArray &line);
+  Skyscraper *getContext(const QString &platform, const QString &module, QString &error);
+  QJsonObject entryToJson(const GameEntry &entry);
+  void sendResult(QLocalSocket *socket, const QJsonValue &id, const QJsonValue &result);
+  void sendError(QLocalSocket *socket, const QJsonValue &id, const int &code,
+		 const QString &message);
+  void requestDone();
+
+  const QCommandLineParser &parser;
+  QString currentDir;
+  QLocalServer server;
+  QMap<QString, Skyscraper *> contexts;
+  int pending = 0;
+  bool shuttingDown = false;
+
+};
+
+#endif // DAEMON_H
@@ -0,0 +1,129 @@
+/***************************************************************************
+ *            disktools.cpp
+ *
+ *  Sun Oct 18 15:18:10 UTC 2026
+ ****************************************************************************/
+/*
+ *  This file is part of skyscraper.
+ *
+ *  skyscraper is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  skyscraper is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with skyscraper; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA.
+ */
+
+#include <QtGlobal>
+
+#if defined(Q_OS_LINUX) || defined(Q_OS_MACOS)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#endif
+
+#if defined(Q_OS_LINUX)
+#include <sys/ioctl.h>
+#include <linux/fs.h>
+#include <linux/fiemap.h>
+#endif
+
+#include <algorithm>
+
+#include "disktools.h"
+
+void DiskTools::sortByDiskLocation(QList<QFileInfo> &fileInfos)
+{
+  QList<QPair<quint64, QFileInfo> > sortList;
+
+  // Prefer the physical location of the first extent. If the file system doesn't support
+  // FIEMAP for all files, use inode numbers instead, as they usually follow allocation order
+  bool useExtents = true;
+  foreach(QFileInfo info, fileInfos) {
+    quint64 physical = 0;
+    if(!getFirstExtent(info, physical)) {
+      useExtents = false;
+      break;
+    }
+    sortList.append(qMakePair(physical, info));
+  }
+  if(!useExtents) {
+    sortList.clear();
+    foreach(QFileInfo info, fileInfos) {
+      sortList.append(qMakePair(getInode(info), info));
+    }
+  }
+
+  // Stable sort so files with same location (eg. empty files) keep their filename order
+  std::stable_sort(sortList.begin(), sortList.end(),
+		   [](const QPair<quint64, QFileInfo> &a,
+		      const QPair<quint64, QFileInfo> &b) -> bool {
+		     return a.first < b.first;
+		   });
+
+  fileInfos.clear();
+  for(int a = 0; a < sortList.length(); ++a) {
+    fileInfos.append(sortList.at(a).second);
+  }
+}
+
+void DiskTools::dropFromPageCache(const QFileInfo &info)
+{
+#if defined(Q_OS_LINUX)
+  int fd = open(info.absoluteFilePath().toLocal8Bit().constData(), O_RDONLY);
+  if(fd != -1) {
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+  }
+#else
+  Q_UNUSED(info);
+#endif
+}
+
+bool DiskTools::getFirstExtent(const QFileInfo &info, quint64 &physical)
+{
+#if defined(Q_OS_LINUX)
+  int fd = open(info.absoluteFilePath().toLocal8Bit().constData(), O_RDONLY);
+  if(fd == -1) {
+    return false;
+  }
+  // Room for the fiemap header and a single extent, we only need the first one
+  QByteArray buffer(sizeof(struct fiemap) + sizeof(struct fiemap_extent), '\0');
+  struct fiemap *fiemap = (struct fiemap *)buffer.data();
+  fiemap->fm_start = 0;
+  fiemap->fm_length = FIEMAP_MAX_OFFSET;
+  fiemap->fm_extent_count = 1;
+  bool result = false;
+  if(ioctl(fd, FS_IOC_FIEMAP, fiemap) == 0) {
+    // Files with no extents (empty or inline data) sort first
+    physical = (fiemap->fm_mapped_extents > 0?fiemap->fm_extents[0].fe_physical:0);
+    result = true;
+  }
+  close(fd);
+  return result;
+#else
+  Q_UNUSED(info);
+  Q_UNUSED(physical);
+  return false;
+#endif
+}
+
+quint64 DiskTools::getInode(const QFileInfo &info)
+{
+#if defined(Q_OS_LINUX) || defined(Q_OS_MACOS)
+  struct stat fileStat;
+  if(stat(info.absoluteFilePath().toLocal8Bit().constData(), &fileStat) == 0) {
+    return fileStat.st_ino;
+  }
+#else
+  Q_UNUSED(info);
+#endif
+  return 0;
+}
@@ -0,0 +1,42 @@
+/***************************************************************************
+ *            disktools.h
+ *
+ *  Sun Oct 18 15:18:10 UTC 2026
+ ****************************************************************************/
+/*
+ *  This file is part of skyscraper.
+ *
+ *  skyscraper is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  skyscraper is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with skyscraper; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA.
+ */
+
+#ifndef DISKTOOLS_H
+#define DISKTOOLS_H
+
+#include <QObject>
+#include <QFileInfo>
+
+class DiskTools : public QObject
+{
+public:
+  static void sortByDiskLocation(QList<QFileInfo> &fileInfos);
+  static void dropFromPageCache(const QFileInfo &info);
+
+private:
+  static bool getFirstExtent(const QFileInfo &info, quint64 &physical);
+  static quint64 getInode(const QFileInfo &info);
+
+};
+
+#endif // DISKTOOLS_H
@@ -45,7 +45,7 @@ bool EmulationStation::loadOldGameList(const QString &gameListFileString)
   return false;
 }
 
-bool EmulationStation::skipExisting(QList<GameEntry> &gameEntries, QSharedPointer<Queue> queue) 
+bool EmulationStation::skipExisting(QList<GameEntry> &gameEntries, QList<QFileInfo> &queue) 
 {
   gameEntries = oldEntries;
 
@@ -58,18 +58,18 @@ bool EmulationStation::skipExisting(QList<GameEntry> &gameEntries, QSharedPointe
       fflush(stdout);
     }
     QFileInfo current(gameEntries.at(a).path);
-    for(int b = 0; b < queue->length(); ++b) {
+    for(int b = 0; b < queue.length(); ++b) {
       if(current.isFile()) {
-	if(current.fileName() == queue->at(b).fileName()) {
-	  queue->removeAt(b);
+	if(current.fileName() == queue.at(b).fileName()) {
+	  queue.removeAt(b);
 	  // We assume filename is unique, so break after getting first hit
 	  break;
 	}
       } else if(current.isDir()) {
 	// Use current.absoluteFilePath here since it is already a path. Otherwise it will use
 	// the parent folder
-	if(current.absoluteFilePath() == queue->at(b).absolutePath()) {
-	  queue->removeAt(b);
+	if(current.absoluteFilePath() == queue.at(b).absolutePath()) {
+	  queue.removeAt(b);
 	  // We assume filename is unique, so break after getting first hit
 	  break;
 	}
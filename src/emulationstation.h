@@ -35,7 +35,7 @@ class EmulationStation : public AbstractFrontend
 public:
   EmulationStation();
   void assembleList(QString &finalOutput, const QList<GameEntry> &gameEntries) override;
-  bool skipExisting(QList<GameEntry> &gameEntries, QSharedPointer<Queue> queue) override;
+  bool skipExisting(QList<GameEntry> &gameEntries, QList<QFileInfo> &queue) override;
   bool canSkip() override;
   bool loadOldGameList(const QString &gameListFileString) override;
   void preserveFromOld(GameEntry &entry) override;
@@ -0,0 +1,121 @@
+/***************************************************************************
+ *            entryspill.cpp
+ *
+ *  Sun Oct 18 16:11:31 UTC 2026
+ ****************************************************************************/
+/*
+ *  This file is part of skyscraper.
+ *
+ *  skyscraper is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  skyscraper is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with skyscraper; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA.
+ */
+
+#include <QDataStream>
+
+#include "entryspill.h"
+
+// Bump this whenever fields are added to the stream below
+#define SPILLVERSION 1
+
+EntrySpill::EntrySpill()
+{
+  // Placed next to the cache rather than in the temp folder, which is often kept in memory
+  spillFile.setFileTemplate("spill-XXXXXX.tmp");
+}
+
+// Moves the entries to disk. 'entries' is emptied on success
+bool EntrySpill::spill(QList<GameEntry> &entries)
+{
+  if(!spillFile.isOpen()) {
+    if(!spillFile.open()) {
+      return false;
+    }
+    QDataStream header(&spillFile);
+    header << (qint32)SPILLVERSION;
+  }
+  spillFile.seek(spillFile.size());
+  QDataStream out(&spillFile);
+  foreach(GameEntry entry, entries) {
+    out << entry.id << entry.path << entry.title << entry.titleSrc << entry.platform
+	<< entry.platformSrc << entry.description << entry.descriptionSrc << entry.releaseDate
+	<< entry.releaseDateSrc << entry.developer << entry.developerSrc << entry.publisher
+	<< entry.publisherSrc << entry.tags << entry.tagsSrc << entry.players << entry.playersSrc
+	<< entry.ages << entry.agesSrc << entry.rating << entry.ratingSrc
+	<< entry.coverFile << entry.coverSrc << entry.screenshotFile << entry.screenshotSrc
+	<< entry.wheelFile << entry.wheelSrc << entry.marqueeFile << entry.marqueeSrc
+	<< entry.videoFile << entry.videoSrc
+	<< (qint32)entry.searchMatch << entry.sha1 << entry.source << entry.url << entry.sqrNotes
+	<< entry.parNotes << entry.videoFormat << entry.baseName << entry.found << entry.miscData
+	<< entry.eSFavorite << entry.eSHidden << entry.eSPlayCount << entry.eSLastPlayed
+	<< entry.eSKidGame << entry.eSSortName
+	<< entry.aMCloneOf << entry.aMRotation << entry.aMControl << entry.aMStatus
+	<< entry.aMDisplayCount << entry.aMDisplayType << entry.aMAltRomName << entry.aMAltTitle
+	<< entry.aMExtra << entry.aMButtons;
+  }
+  if(out.status() != QDataStream::Ok || !spillFile.flush()) {
+    return false;
+  }
+  spilled += entries.length();
+  entries.clear();
+  return true;
+}
+
+// Puts the spilled entries back in front of 'entries' and empties the spill file
+void EntrySpill::restore(QList<GameEntry> &entries)
+{
+  if(!spillFile.isOpen() || spilled == 0) {
+    return;
+  }
+  QList<GameEntry> restored;
+  spillFile.seek(0);
+  QDataStream in(&spillFile);
+  qint32 version = 0;
+  in >> version;
+  for(int a = 0; a < spilled && version == SPILLVERSION && !in.atEnd(); ++a) {
+    GameEntry entry;
+    qint32 searchMatch = 0;
+    in >> entry.id >> entry.path >> entry.title >> entry.titleSrc >> entry.platform
+       >> entry.platformSrc >> entry.description >> entry.descriptionSrc >> entry.releaseDate
+       >> entry.releaseDateSrc >> entry.developer >> entry.developerSrc >> entry.publisher
+       >> entry.publisherSrc >> entry.tags >> entry.tagsSrc >> entry.players >> entry.playersSrc
+       >> entry.ages >> entry.agesSrc >> entry.rating >> entry.ratingSrc
+       >> entry.coverFile >> entry.coverSrc >> entry.screenshotFile >> entry.screenshotSrc
+       >> entry.wheelFile >> entry.wheelSrc >> entry.marqueeFile >> entry.marqueeSrc
+       >> entry.videoFile >> entry.videoSrc
+       >> searchMatch >> entry.sha1 >> entry.source >> entry.url >> entry.sqrNotes
+       >> entry.parNotes >> entry.videoFormat >> entry.baseName >> entry.found >> entry.miscData
+       >> entry.eSFavorite >> entry.eSHidden >> entry.eSPlayCount >> entry.eSLastPlayed
+       >> entry.eSKidGame >> entry.eSSortName
+       >> entry.aMCloneOf >> entry.aMRotation >> entry.aMControl >> entry.aMStatus
+       >> entry.aMDisplayCount >> entry.aMDisplayType >> entry.aMAltRomName >> entry.aMAltTitle
+       >> entry.aMExtra >> entry.aMButtons;
+    if(in.status() != QDataStream::Ok) {
+      break;
+    }
+    entry.searchMatch = searchMatch;
+    restored.append(entry);
+  }
+  if(restored.length() != spilled) {
+    printf("\033[1;31mCouldn't read back all game list entries from '%s', %d entries are missing from the game list!\033[0m\n", spillFile.fileName().toStdString().c_str(), spilled - restored.length());
+  }
+  entries = restored + entries;
+  spillFile.resize(0);
+  spillFile.close();
+  spilled = 0;
+}
+
+int EntrySpill::count()
+{
+  return spilled;
+}
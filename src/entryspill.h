@@ -0,0 +1,48 @@
+/***************************************************************************
+ *            entryspill.h
+ *
+ *  Sun Oct 18 16:11:31 UTC 2026
+ ****************************************************************************/
+/*
+ *  This file is part of skyscraper.
+ *
+ *  skyscraper is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  skyscraper is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with skyscraper; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA.
+ */
+
+#ifndef ENTRYSPILL_H
+#define ENTRYSPILL_H
+
+#include <QList>
+#include <QTemporaryFile>
+
+#include "gameentry.h"
+
+// Holds finished game list entries on disk until the game list is written, so they don't take
+// up memory during long runs. Media data isn't kept, only the metadata and file paths
+class EntrySpill
+{
+public:
+  EntrySpill();
+  bool spill(QList<GameEntry> &entries);
+  void restore(QList<GameEntry> &entries);
+  int count();
+
+private:
+  QTemporaryFile spillFile;
+  int spilled = 0;
+
+};
+
+#endif // ENTRYSPILL_H
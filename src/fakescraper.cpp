@@ -0,0 +1,62 @@
+/***************************************************************************
+ *            fakescraper.cpp
+ *
+ *  Sun Oct 18 15:59:49 UTC 2026
+ ****************************************************************************/
+/*
+ *  This file is part of skyscraper.
+ *
+ *  skyscraper is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  skyscraper is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with skyscraper; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA.
+ */
+
+#include <QCryptographicHash>
+#include <QColor>
+
+#include "fakescraper.h"
+
+FakeScraper::FakeScraper(Settings *config) : AbstractScraper(config)
+{
+}
+
+void FakeScraper::runPasses(QList<GameEntry> &gameEntries, const QFileInfo &info, QString &,
+			    QString &)
+{
+  GameEntry game;
+  game.title = getCompareTitle(info);
+  game.platform = config->platform;
+  gameEntries.append(game);
+}
+
+// Everything is derived from the title, so the same file always gets the same data
+void FakeScraper::getGameData(GameEntry &game)
+{
+  QByteArray hash = QCryptographicHash::hash(game.title.toUtf8(), QCryptographicHash::Md5);
+  game.description = "Fake description of '" + game.title + "'.";
+  game.releaseDate = QString::number(1980 + (quint8)hash.at(0) % 30) + "0101";
+  game.developer = "Fake Developer";
+  game.publisher = "Fake Publisher";
+  game.players = QString::number(1 + (quint8)hash.at(1) % 4);
+  game.ages = "3";
+  game.tags = "Fake, Test";
+  game.rating = QString::number((quint8)hash.at(2) / 255.0, 'f', 2);
+  if(config->cacheCovers) {
+    game.coverData = QImage(320, 448, QImage::Format_RGB32);
+    game.coverData.fill(QColor((quint8)hash.at(3), (quint8)hash.at(4), (quint8)hash.at(5)));
+  }
+  if(config->cacheScreenshots) {
+    game.screenshotData = QImage(320, 240, QImage::Format_RGB32);
+    game.screenshotData.fill(QColor((quint8)hash.at(6), (quint8)hash.at(7), (quint8)hash.at(8)));
+  }
+}
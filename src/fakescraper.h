@@ -0,0 +1,43 @@
+/***************************************************************************
+ *            fakescraper.h
+ *
+ *  Sun Oct 18 15:59:49 UTC 2026
+ ****************************************************************************/
+/*
+ *  This file is part of skyscraper.
+ *
+ *  skyscraper is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  skyscraper is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with skyscraper; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA.
+ */
+
+#ifndef FAKESCRAPER_H
+#define FAKESCRAPER_H
+
+#include "abstractscraper.h"
+
+// Scraping module that makes up its data from the filename without using the network. Used
+// for testing the daemon and the scraping pipeline locally. Only available in daemon mode
+class FakeScraper : public AbstractScraper
+{
+  Q_OBJECT
+
+public:
+  FakeScraper(Settings *config);
+  void runPasses(QList<GameEntry> &gameEntries, const QFileInfo &info, QString &,
+		 QString &) override;
+  void getGameData(GameEntry &game) override;
+
+};
+
+#endif // FAKESCRAPER_H
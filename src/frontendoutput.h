@@ -0,0 +1,50 @@
+/***************************************************************************
+ *            frontendoutput.h
+ *
+ *  Sun Oct 18 15:47:04 UTC 2026
+ ****************************************************************************/
+/*
+ *  This file is part of skyscraper.
+ *
+ *  skyscraper is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  skyscraper is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with skyscraper; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA.
+ */
+
+#ifndef FRONTENDOUTPUT_H
+#define FRONTENDOUTPUT_H
+
+#include <QList>
+#include <QString>
+#include <QSharedPointer>
+
+#include "abstractfrontend.h"
+#include "compositor.h"
+#include "entryspill.h"
+#include "gameentry.h"
+#include "settings.h"
+
+// Game list and media output for each additional frontend set with '-f'. The files are only
+// hashed and resolved from the cache once, and the results are then written for every frontend
+struct FrontendOutput {
+  ~FrontendOutput() { delete frontend; };
+  AbstractFrontend *frontend = nullptr;
+  // Copy of the main config with this frontend's folders and artwork
+  Settings config;
+  QSharedPointer<Compositor> compositor;
+  QList<GameEntry> gameEntries;
+  EntrySpill entrySpill;
+  QString gameListFileString = "";
+};
+
+#endif // FRONTENDOUTPUT_H
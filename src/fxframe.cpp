@@ -36,7 +36,7 @@ QImage FxFrame::applyEffect(const QImage &src, const Layer &layer, Settings *con
 {
   QImage canvas = src;
 
-  QImage frame(config->resources[layer.resource]);
+  QImage frame(config->resources.value(layer.resource));
   frame = frame.convertToFormat(QImage::Format_ARGB32_Premultiplied);
 
   if(layer.width == -1 && layer.height == -1) {
@@ -43,7 +43,7 @@ QImage FxGamebox::applyEffect(const QImage &src, const Layer &layer,
   QImage front(src.width(), src.height() + src.height() * borderFactor,
 	       QImage::Format_ARGB32_Premultiplied);
   front.fill(Qt::black);
-  QImage overlayFront(config->resources["boxfront.png"]);
+  QImage overlayFront(config->resources.value("boxfront.png"));
   overlayFront = overlayFront.scaled(front.width(), front.height(),
 				     Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
   
@@ -52,7 +52,7 @@ QImage FxGamebox::applyEffect(const QImage &src, const Layer &layer,
   painter.drawImage(0, 0, overlayFront);
   painter.end();
 
-  QImage overlaySide(config->resources["boxside.png"]);
+  QImage overlaySide(config->resources.value("boxside.png"));
   overlaySide = overlaySide.scaledToHeight(front.height(), Qt::SmoothTransformation);
 
   QImage side(overlaySide.width(), overlaySide.height(), QImage::Format_ARGB32_Premultiplied);
@@ -69,7 +69,7 @@ QImage FxGamebox::applyEffect(const QImage &src, const Layer &layer,
   } else if(layer.resource == "marquee") {
     sideImage = game.marqueeData;
   } else {
-    sideImage = QImage(config->resources[layer.resource]);
+    sideImage = QImage(config->resources.value(layer.resource));
   }
   sideImage = sideImage.convertToFormat(QImage::Format_ARGB32_Premultiplied);
   
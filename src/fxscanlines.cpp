@@ -76,7 +76,7 @@ QImage FxScanlines::applyEffect(const QImage &src, const Layer &layer, Settings
   painter.begin(&canvas);
   painter.setOpacity(opacity * 0.01);
   painter.setCompositionMode(layer.mode);
-  painter.drawImage(0, 0, (scaling != 1.0?config->resources[resource].scaledToWidth((int)((double)config->resources[resource].width() * scaling), Qt::FastTransformation):config->resources[resource]));
+  painter.drawImage(0, 0, (scaling != 1.0?config->resources.value(resource).scaledToWidth((int)((double)config->resources.value(resource).width() * scaling), Qt::FastTransformation):config->resources.value(resource)));
   painter.end();
 
   return canvas;
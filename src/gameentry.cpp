@@ -94,3 +94,14 @@ void GameEntry::resetMedia()
   marqueeData = QImage();
   videoData = "";
 }
+
+// Once an entry is in the cache, only what's needed for the console output and the game lists
+// is kept. The media data and the scraping module's own lookup data are dropped
+void GameEntry::stripForList()
+{
+  resetMedia();
+  id = "";
+  url = "";
+  source = "";
+  miscData = "";
+}
@@ -49,6 +49,7 @@ public:
   GameEntry();
   int completeness(bool videoEnabled = false);
   void resetMedia();
+  void stripForList();
   
   QString id = "";
   QString path = "";
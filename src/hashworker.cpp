@@ -0,0 +1,101 @@
+/***************************************************************************
+ *            hashworker.cpp
+ *
+ *  Sun Oct 18 15:25:32 UTC 2026
+ ****************************************************************************/
+/*
+ *  This file is part of skyscraper.
+ *
+ *  skyscraper is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  skyscraper is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with skyscraper; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA.
+ */
+
+#include "hashworker.h"
+#include "nametools.h"
+#include "checksumtools.h"
+
+HashWorker::HashWorker(QSharedPointer<Queue> queue,
+		       QSharedPointer<BoundedQueue<HashedEntry> > hashedQueue,
+		       QSharedPointer<BoundedQueue<HashedEntry> > cachedQueue,
+		       QSharedPointer<Cache> cache, const Settings &config,
+		       const int &workerId)
+{
+  this->queue = queue;
+  this->hashedQueue = hashedQueue;
+  this->cachedQueue = cachedQueue;
+  this->cache = cache;
+  this->config = config;
+  this->workerId = workerId;
+}
+
+HashWorker::~HashWorker()
+{
+}
+
+void HashWorker::run()
+{
+  // ScreenScraper identifies roms by their checksums. They are calculated here, so the files
+  // aren't read by the network bound scraper threads
+  bool moduleChecksums = (config.scraper == "screenscraper");
+  // These modules look up data by filename, so identical files can't share results
+  bool dedupe = (config.scraper != "cache" && config.scraper != "import" &&
+		 config.scraper != "esgamelist");
+  QFileInfo info;
+  while(queue->takeEntry(info, workerId)) {
+    HashedEntry entry;
+    entry.info = info;
+    if(moduleChecksums && !config.crcOnly && NameTools::isSha1FromData(info)) {
+      // The cache sha1 is calculated from the same data, so the file is only read once
+      entry.checksums = ChecksumTools::getChecksums(info, config.unpack);
+      if(entry.checksums.valid && !entry.checksums.unpacked) {
+	entry.sha1 = entry.checksums.sha1;
+      }
+    }
+    if(entry.sha1.isEmpty()) {
+      entry.sha1 = NameTools::getSha1(info);
+    }
+    if(!cachedQueue.isNull() && cache->hasEntries(entry.sha1, config.scraper)) {
+      cachedQueue->push(entry);
+    } else {
+      if(moduleChecksums && !entry.checksums.valid) {
+	entry.checksums = (config.crcOnly?ChecksumTools::getCrc(info):
+			   ChecksumTools::getChecksums(info, config.unpack));
+      }
+      if(dedupe) {
+	entry.contentId = getContentId(entry);
+      }
+      hashedQueue->push(entry);
+    }
+  }
+  hashedQueue->producerDone();
+  if(!cachedQueue.isNull()) {
+    cachedQueue->producerDone();
+  }
+  emit allDone();
+}
+
+QString HashWorker::getContentId(const HashedEntry &entry)
+{
+  // Empty files have nothing to tell them apart
+  if(entry.info.size() == 0) {
+    return QString();
+  }
+  if(entry.checksums.valid && !entry.checksums.sha1.isEmpty()) {
+    return entry.checksums.sha1;
+  }
+  if(NameTools::isSha1FromData(entry.info)) {
+    return entry.sha1;
+  }
+  return QString();
+}
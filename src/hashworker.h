@@ -0,0 +1,81 @@
+/***************************************************************************
+ *            hashworker.h
+ *
+ *  Sun Oct 18 15:25:32 UTC 2026
+ ****************************************************************************/
+/*
+ *  This file is part of skyscraper.
+ *
+ *  skyscraper is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  skyscraper is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with skyscraper; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA.
+ */
+
+#ifndef HASHWORKER_H
+#define HASHWORKER_H
+
+#include <QObject>
+#include <QFileInfo>
+#include <QSharedPointer>
+
+#include "queue.h"
+#include "boundedqueue.h"
+#include "cache.h"
+#include "settings.h"
+#include "checksumtools.h"
+
+// Max number of hashed files waiting for a scraper worker
+#define HASHQUEUESIZE 32
+
+struct HashedEntry {
+  QFileInfo info;
+  QString sha1 = "";
+  // Only calculated for the modules that identify roms by their data
+  RomChecksums checksums;
+  // Identifies the file by its data, so identical files are only scraped once. Empty if the
+  // file can only be identified by its filename, in which case it is always scraped
+  QString contentId = "";
+};
+
+// First stage of a scraping run. Reads and checksums the files from the rom queue and
+// passes them on to the scraper workers, so disk reads overlap the network and cpu work.
+// If a 'cachedQueue' is given, files that already have resources from the scraping module
+// are passed on through that instead, so they don't wait behind the network bound files
+class HashWorker : public QObject
+{
+  Q_OBJECT
+
+public:
+  HashWorker(QSharedPointer<Queue> queue,
+	     QSharedPointer<BoundedQueue<HashedEntry> > hashedQueue,
+	     QSharedPointer<BoundedQueue<HashedEntry> > cachedQueue,
+	     QSharedPointer<Cache> cache, const Settings &config, const int &workerId);
+  ~HashWorker();
+  void run();
+
+signals:
+  void allDone();
+
+private:
+  QSharedPointer<Queue> queue;
+  QSharedPointer<BoundedQueue<HashedEntry> > hashedQueue;
+  QSharedPointer<BoundedQueue<HashedEntry> > cachedQueue;
+  QSharedPointer<Cache> cache;
+  Settings config;
+  int workerId;
+
+  QString getContentId(const HashedEntry &entry);
+
+};
+
+#endif // HASHWORKER_H
@@ -49,10 +49,14 @@
 
 #include "strtools.h"
 #include "skyscraper.h"
+#include "batch.h"
+#include "daemon.h"
 #include "scripter.h"
 #include "platform.h"
 
-Skyscraper *x;
+Skyscraper *x = nullptr;
+Batch *batch = nullptr;
+Daemon *daemonServer = nullptr;
 int sigIntRequests = 0;
 
 void customMessageHandler(QtMsgType type, const QMessageLogContext&, const QString &msg)
@@ -98,12 +102,26 @@ BOOL WINAPI ConsoleHandler(DWORD dwType)
   if(dwType == CTRL_C_EVENT) {
     sigIntRequests++;
 #endif
-    if(sigIntRequests <= 2) {
+    if(sigIntRequests <= 2 && daemonServer != nullptr) {
+      printf("User wants to quit, trying to exit nicely. Waiting for the pending requests to finish...\n");
+      daemonServer->shutdown();
+    } else if(sigIntRequests <= 2 && batch != nullptr) {
+      if(batch->threadsRunning()) {
+	printf("User wants to quit, trying to exit nicely. The platforms that are running will finish their current games, the rest are skipped...\n");
+	batch->stopRun();
+      } else {
+	exit(1);
+      }
+    } else if(sigIntRequests <= 2) {
+      bool watching = x->watchMode;
+      // Stop watching for new files so we quit once the current run is done
+      x->watchMode = false;
       if(x->threadsRunning) {
 	printf("User wants to quit, trying to exit nicely. This can take a few seconds depending on how many threads you have running...\n");
-	x->queue->clearAll();
+	x->stopRun();
       } else {
-	exit(1);
+	// When idle in watch mode everything has already been written, so this is a clean exit
+	exit(watching?0:1);
       }
     } else {
       printf("User REALLY wants to quit NOW, forcing unclean exit...\n");
@@ -186,8 +204,8 @@ int main(int argc, char *argv[])
   parser.setApplicationDescription(StrTools::getVersionHeader() + "Skyscraper looks for compatible game files in the input directory (set with '-i'). It allows you to fetch and cache media and game information resources for the files using various scraping modules (set with '-s'). It then lets you built game lists for the supported frontends by combining all previously cached resources ('game list generation mode' is initiated by simply leaving out the '-s' option). While doing so it also composites game art for all files by following the recipe at '~/.skyscraper/artwork.xml'.\n\nIn addition to the command line options Skyscraper also provides a lot of customizable options for configuration, artwork, game name aliases, resource priorities and much more. Please check the full documentation at 'https://github.com/muldjord/skyscraper/docs' for a detailed explanation of all features.\n\nRemember that most of the following options can also be set in the '~/.skyscraper/config.ini' file. All cli options and config.ini options are thoroughly documented in the above link.");
   parser.addHelpOption();
   parser.addVersionOption();
-  QCommandLineOption pOption("p", "The platform you wish to scrape.\n(Currently supports " + platforms + ".)", "PLATFORM", "");
-  QCommandLineOption fOption("f", "Frontend to scrape for.\n(Currently supports 'emulationstation' and 'attractmode'. Default is 'emulationstation')", "FRONTEND", "");
+  QCommandLineOption pOption("p", "The platform you wish to scrape. Several platforms can be set as a comma separated list, in which case they are processed one after the other in a single run.\n(Currently supports " + platforms + ".)", "PLATFORM", "");
+  QCommandLineOption fOption("f", "Frontend to scrape for.\n(Currently supports 'emulationstation' and 'attractmode'. Default is 'emulationstation'. Several frontends can be set as a comma separated list, such as 'emulationstation,attractmode')", "FRONTEND", "");
   QCommandLineOption eOption("e", "Set emulator. This is only required by the 'attractmode' frontend.\n(Default is none)", "EMULATOR", "");
   QCommandLineOption iOption("i", "Folder which contains the game/rom files.\n(default is '~/RetroPie/roms/<PLATFORM>')", "PATH", "");
   QCommandLineOption gOption("g", "Game list export folder.\n(default depends on frontend)", "PATH", "");
@@ -196,7 +214,7 @@ int main(int argc, char *argv[])
   QCommandLineOption uOption("u", "userKey or UserID and Password for use with the selected scraping module.\n(Default is none)", "KEY/USER:PASSWORD", "");
   QCommandLineOption mOption("m", "Minimum match percentage when comparing search result titles to filename titles.\n(default is 65)", "0-100", "");
   QCommandLineOption lOption("l", "Maximum game description length. Everything longer than this will be truncated.\n(default is 2500)", "0-10000", "");
-  QCommandLineOption tOption("t", "Number of scraper threads to use. This might change depending on the scraping module limits.\n(default is 4)", "1-8", "");
+  QCommandLineOption tOption("t", "Number of scraper threads to use. This might change depending on the scraping module limits. Set it to 'auto' to let Skyscraper adjust the number of threads as it goes.\n(default is 4)", "1-8|auto", "");
   QCommandLineOption cOption("c", "Use this config file to set up Skyscraper.\n(default is '~/.skyscraper/config.ini')", "FILENAME", "");
   QCommandLineOption aOption("a", "Use this artwork xml file to set up the artwork compositing.\n(default is '~/.skyscraper/artwork.xml')", "FILENAME", "");
   QCommandLineOption dOption("d", "Set custom resource cache folder.\n(default is '~/.skyscraper/cache/<PLATFORM>')", "FOLDER", "");
@@ -210,11 +228,20 @@ int main(int argc, char *argv[])
   QCommandLineOption nobracketsOption("nobrackets", "Disables any [] and () tags in the frontend game titles.");
   QCommandLineOption relativeOption("relative", "Forces all gamelist paths to be relative to rom location.");
   QCommandLineOption addextOption("addext", "Add this or these file extension(s) to accepted file extensions during a scraping run. (example: '*.zst' or '*.zst *.ext)", "EXTENSION(S)", "");
-  QCommandLineOption cacheOption("cache", "This option is the master option for all options related to the resource cache. It must be followed by 'COMMAND[:OPTIONS]'.\n'show' Will print a status of all cached resources.\n'validate' will check the consistency of the cache.\n'edit' will allow editing of the resources in the rom queue.\n'vacuum' Will compare your romset to any cached resource and remove the resources that you no longer have roms for.\n'report:missing=<RESOURCE>' will generate a report with all files that are missing the specified resource (eg. 'players', 'developer', 'description').\n'merge:<PATH>' will merge two caches together.\n'purge:all' Will remove ALL cached resources for the selected platform.\n'purge:m=<MODULE>,t=<TYPE>' Will remove cached resources related to the selected module(m) and / or type(t). Either one can be left out in which case ALL resources from the selected module or ALL resources from the selected type will be removed.\n'refresh' Will force a refresh of existing cached resources for any scraping module. Requires a scraping module set with '-s'.", "COMMAND[:OPTIONS]", "");
+  QCommandLineOption cacheOption("cache", "This option is the master option for all options related to the resource cache. It must be followed by 'COMMAND[:OPTIONS]'.\n'show' Will print a status of all cached resources.\n'validate' will check the consistency of the cache.\n'edit' will allow editing of the resources in the rom queue.\n'vacuum' Will compare your romset to any cached resource and remove the resources that you no longer have roms for.\n'report:missing=<RESOURCE>' will generate a report with all files that are missing the specified resource (eg. 'players', 'developer', 'description').\n'merge:<PATH>[,<PATH>...]' will merge one or more caches into the cache of the selected platform.\n'purge:all' Will remove ALL cached resources for the selected platform.\n'purge:m=<MODULE>,t=<TYPE>' Will remove cached resources related to the selected module(m) and / or type(t). Either one can be left out in which case ALL resources from the selected module or ALL resources from the selected type will be removed.\n'refresh' Will force a refresh of existing cached resources for any scraping module. Requires a scraping module set with '-s'.", "COMMAND[:OPTIONS]", "");
   QCommandLineOption refreshOption("refresh", "Same as '--cache refresh'.");
   QCommandLineOption noresizeOption("noresize", "Disable resizing of artwork when saving it to the resource cache. Normally they are resized to save space. Setting this option will save them as is. NOTE! This is NOT related to how Skyscraper renders the artwork when scraping. Check the online 'Artwork' documentation to know more about this.");
   QCommandLineOption nosubdirsOption("nosubdirs", "Do not include input folder subdirectories when scraping.");
-  QCommandLineOption unpackOption("unpack", "Unpacks and checksums the file inside 7z or zip files instead of the compressed file itself. Be aware that this option requires '7z' to be installed on the system to work. Only relevant for 'screenscraper' scraping module.");
+  QCommandLineOption diskorderOption("diskorder", "Process files in the order they are physically located on disk instead of by filename. This speeds up checksumming on spinning disks and SD cards. The game list is still sorted by name.");
+  QCommandLineOption hashbenchOption("hashbench", "Benchmarks checksumming of all files in the input folder in filename order versus disk location order, and then exits.");
+  QCommandLineOption singlepassOption("singlepass", "When scraping with a module, also generates the game list in the same run. Each game is added to the game list as soon as its resources are in the cache, so a separate game list generation run isn't needed.");
+  QCommandLineOption timebudgetOption("timebudget", "Stops the scraping run nicely once this many minutes have passed. The resource cache is saved and a checkpoint is written so the run can be continued later with '--resume'.", "MINUTES", "");
+  QCommandLineOption resumeOption("resume", "Continues a scraping run from where the checkpoint of a previous run stopped. Files that were already processed are skipped.");
+  QCommandLineOption daemonOption("daemon", "Keeps Skyscraper running in the background and serves 'lookup', 'generate' and 'scrape' requests for single files as JSON-RPC over the local socket '~/.skyscraper/skyscraper.sock'. The resource caches, maps and artwork definitions stay in memory between requests.");
+  QCommandLineOption shardOption("shard", "Only scrapes the files belonging to this shard out of COUNT shards, such as '2/4'. Files are assigned to the shards by their path, so a large romset can be split across several processes or machines. Combine the resulting caches afterwards with '--cache merge:<FOLDER>[,<FOLDER>...]'.", "INDEX/COUNT", "");
+  QCommandLineOption watchOption("watch", "Keeps running after the initial run and watches the input folder for new or changed files. These are then scraped and the resource cache and game list are updated incrementally. Quit with Ctrl+C.");
+  QCommandLineOption unpackOption("unpack", "Unpacks and checksums the file inside 7z or zip files instead of the compressed file itself. Zip files are unpacked internally, 7z files (and zip files using unsupported compression methods) require '7z' to be installed on the system. Only relevant for 'screenscraper' scraping module.");
+  QCommandLineOption crconlyOption("crconly", "Only use crc and file size to identify roms. For zip files containing a single file, these are read directly from the zip file header without unpacking anything. This makes checksumming very fast, but might give fewer matches. Only relevant for 'screenscraper' scraping module.");
   QCommandLineOption forcefilenameOption("forcefilename", "Use filename as game name instead of the returned game title when generating a game list.");
   QCommandLineOption startatOption("startat", "Tells Skyscraper which file to start at. Forces '--refresh' and '--nosubdirs' enabled.", "FILENAME", "");
   QCommandLineOption endatOption("endat", "Tells Skyscraper which file to end at. Forces '--refresh' and '--nosubdirs' enabled.", "FILENAME", "");
@@ -234,7 +261,16 @@ int main(int argc, char *argv[])
   parser.addOption(uOption);
   parser.addOption(iOption);
   parser.addOption(nosubdirsOption);
+  parser.addOption(diskorderOption);
+  parser.addOption(hashbenchOption);
+  parser.addOption(watchOption);
+  parser.addOption(daemonOption);
+  parser.addOption(singlepassOption);
+  parser.addOption(timebudgetOption);
+  parser.addOption(resumeOption);
+  parser.addOption(shardOption);
   parser.addOption(unpackOption);
+  parser.addOption(crconlyOption);
   parser.addOption(gOption);
   parser.addOption(oOption);
   parser.addOption(tOption);
@@ -277,6 +313,42 @@ int main(int argc, char *argv[])
   if(argc > 1) {
     if(parser.isSet("help") || parser.isSet("h")) {
       parser.showHelp();
+    } else if(parser.isSet("daemon")) {
+      // The platform, module and files are given with each request
+      if(parser.isSet("p") || parser.isSet("s") || !parser.positionalArguments().isEmpty() ||
+	 parser.isSet("startat") || parser.isSet("endat") || parser.isSet("query") ||
+	 parser.isSet("hashbench") || parser.isSet("watch") || parser.isSet("singlepass") ||
+	 parser.isSet("timebudget") || parser.isSet("resume") || parser.isSet("shard") ||
+	 parser.isSet("cache")) {
+	printf("'-p', '-s', filenames, '--startat', '--endat', '--query', '--hashbench', '--watch', '--singlepass', '--timebudget', '--resume', '--shard' and '--cache' can't be used with '--daemon', now exiting...\n");
+	exit(1);
+      }
+      daemonServer = new Daemon(parser, currentDir);
+      QObject::connect(daemonServer, &Daemon::finished, &app, &QCoreApplication::quit);
+      QTimer::singleShot(0, daemonServer, SLOT(run()));
+    } else if(parser.value("p").contains(",")) {
+      QList<QString> batchPlatforms;
+      foreach(QString platform, parser.value("p").split(",", QString::SkipEmptyParts)) {
+	platform = platform.simplified();
+	if(!Platform::getPlatforms().contains(platform)) {
+	  printf("Platform '%s' isn't supported. Check '--help' for a list of supported platforms, now exiting...\n", platform.toStdString().c_str());
+	  exit(1);
+	}
+	if(!batchPlatforms.contains(platform)) {
+	  batchPlatforms.append(platform);
+	}
+      }
+      // These options only make sense for a single platform
+      if(!parser.positionalArguments().isEmpty() || parser.isSet("startat") ||
+	 parser.isSet("endat") || parser.isSet("query") || parser.isSet("hashbench") ||
+	 parser.isSet("watch") ||
+	 (parser.isSet("cache") && parser.value("cache") != "refresh")) {
+	printf("Filenames, '--startat', '--endat', '--query', '--hashbench', '--watch' and '--cache' commands can't be used with several platforms, now exiting...\n");
+	exit(1);
+      }
+      batch = new Batch(parser, currentDir, batchPlatforms);
+      QObject::connect(batch, &Batch::finished, &app, &QCoreApplication::quit);
+      QTimer::singleShot(0, batch, SLOT(run()));
     } else {
       x = new Skyscraper(parser, currentDir);
       QObject::connect(x, &Skyscraper::finished, &app, &QCoreApplication::quit);
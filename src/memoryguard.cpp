@@ -0,0 +1,165 @@
+/***************************************************************************
+ *            memoryguard.cpp
+ *
+ *  Sun Oct 18 16:11:31 UTC 2026
+ ****************************************************************************/
+/*
+ *  This file is part of skyscraper.
+ *
+ *  skyscraper is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  skyscraper is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with skyscraper; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA.
+ */
+
+#include <QtGlobal>
+#include <QFile>
+#include <QThread>
+#include <QElapsedTimer>
+
+#if defined(Q_OS_LINUX) || defined(Q_OS_MACOS)
+#include <unistd.h>
+#include <sys/resource.h>
+#endif
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#include "memoryguard.h"
+
+qint64 MemoryGuard::budget = 0;
+QAtomicInt MemoryGuard::overBudget(0);
+QAtomicInt MemoryGuard::nearBudget(0);
+QMutex MemoryGuard::throttleMutex;
+
+// A budget of 0 disables it
+void MemoryGuard::setBudget(const qint64 &bytes)
+{
+  budget = bytes;
+  overBudget = 0;
+  nearBudget = 0;
+}
+
+qint64 MemoryGuard::getBudget()
+{
+  return budget;
+}
+
+// Samples the memory usage. Must be called periodically while the workers are running
+void MemoryGuard::update()
+{
+  if(budget <= 0) {
+    return;
+  }
+  qint64 rss = getRss();
+#if defined(__GLIBC__)
+  // Memory freed by the workers isn't necessarily given back to the system, so the usage
+  // might stay high long after the large images and videos are gone. Give it back first
+  if(rss >= budget / 100 * MEMSPILLPERCENT) {
+    malloc_trim(0);
+    rss = getRss();
+  }
+#endif
+  overBudget = (rss >= budget?1:0);
+  nearBudget = (rss >= budget / 100 * MEMSPILLPERCENT?1:0);
+}
+
+bool MemoryGuard::isOverBudget()
+{
+  return overBudget.load() != 0;
+}
+
+bool MemoryGuard::isNearBudget()
+{
+  return nearBudget.load() != 0;
+}
+
+// Called by the workers before starting a new job. When over budget only one worker at a time
+// is let through, each after waiting for the usage to go down for a while. This keeps the run
+// going while the jobs already in progress finish and free their memory
+void MemoryGuard::throttle()
+{
+  if(!isOverBudget()) {
+    return;
+  }
+  QMutexLocker locker(&throttleMutex);
+  QElapsedTimer waited;
+  waited.start();
+  while(isOverBudget() && waited.elapsed() < MEMTHROTTLEMAX) {
+    QThread::msleep(100);
+  }
+}
+
+// Current resident set size in bytes. Returns 0 if unknown
+qint64 MemoryGuard::getRss()
+{
+#if defined(Q_OS_LINUX)
+  QFile statmFile("/proc/self/statm");
+  if(statmFile.open(QIODevice::ReadOnly)) {
+    QList<QByteArray> fields = statmFile.readAll().split(' ');
+    statmFile.close();
+    if(fields.length() >= 2) {
+      return fields.at(1).toLongLong() * sysconf(_SC_PAGESIZE);
+    }
+  }
+#endif
+  return 0;
+}
+
+// Highest resident set size in bytes since the process was started. Returns 0 if unknown
+qint64 MemoryGuard::getPeakRss()
+{
+#if defined(Q_OS_LINUX) || defined(Q_OS_MACOS)
+  struct rusage usage;
+  if(getrusage(RUSAGE_SELF, &usage) == 0) {
+#if defined(Q_OS_MACOS)
+    return (qint64)usage.ru_maxrss;
+#else
+    // Linux reports it in kilobytes
+    return (qint64)usage.ru_maxrss * 1024;
+#endif
+  }
+#endif
+  return 0;
+}
+
+qint64 MemoryGuard::getTotalMemory()
+{
+#if defined(Q_OS_LINUX) || defined(Q_OS_MACOS)
+  long pages = sysconf(_SC_PHYS_PAGES);
+  long pageSize = sysconf(_SC_PAGESIZE);
+  if(pages > 0 && pageSize > 0) {
+    return (qint64)pages * pageSize;
+  }
+#endif
+  return 0;
+}
+
+// Memory the system can hand out without swapping. Returns -1 if unknown
+qint64 MemoryGuard::getAvailableMemory()
+{
+#if defined(Q_OS_LINUX)
+  // Files in /proc have no size, so they must be read in one go
+  QFile memInfoFile("/proc/meminfo");
+  if(memInfoFile.open(QIODevice::ReadOnly)) {
+    QList<QByteArray> lines = memInfoFile.readAll().split('\n');
+    memInfoFile.close();
+    foreach(QByteArray line, lines) {
+      if(line.startsWith("MemAvailable:")) {
+	return line.mid(13).simplified().split(' ').first().toLongLong() * 1024;
+      }
+    }
+  }
+#endif
+  return -1;
+}
@@ -0,0 +1,66 @@
+/***************************************************************************
+ *            memoryguard.h
+ *
+ *  Sun Oct 18 16:11:31 UTC 2026
+ ****************************************************************************/
+/*
+ *  This file is part of skyscraper.
+ *
+ *  skyscraper is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  skyscraper is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with skyscraper; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA.
+ */
+
+#ifndef MEMORYGUARD_H
+#define MEMORYGUARD_H
+
+#include <QMutex>
+#include <QAtomicInt>
+
+// How often the memory usage is sampled in milliseconds
+#define MEMCHECKINTERVAL 1000
+// Default budget in percent of the physical memory when 'memBudget' isn't set
+#define MEMBUDGETPERCENT 75
+// Finished game list entries are moved to disk at this percentage of the budget
+#define MEMSPILLPERCENT 80
+// Skyscraper quits nicely if the system has less than this amount of available memory
+#define MEMAVAILABLELIMIT 52428800
+// Max time in milliseconds a worker is held back when over budget
+#define MEMTHROTTLEMAX 5000
+
+// Process wide memory budget. The usage is sampled from the main thread, and the workers are
+// held back while it is exceeded. Only Linux reports the current usage, on other systems the
+// budget is never exceeded
+class MemoryGuard
+{
+public:
+  static void setBudget(const qint64 &bytes);
+  static qint64 getBudget();
+  static void update();
+  static bool isOverBudget();
+  static bool isNearBudget();
+  static void throttle();
+  static qint64 getRss();
+  static qint64 getPeakRss();
+  static qint64 getTotalMemory();
+  static qint64 getAvailableMemory();
+
+private:
+  static qint64 budget;
+  static QAtomicInt overBudget;
+  static QAtomicInt nearBudget;
+  static QMutex throttleMutex;
+
+};
+
+#endif // MEMORYGUARD_H
@@ -27,16 +27,12 @@
 
 #include "mobygames.h"
 #include "strtools.h"
+#include "ratelimiter.h"
 
 MobyGames::MobyGames(Settings *config) : AbstractScraper(config)
 {
   connect(&manager, &NetComm::dataReady, &q, &QEventLoop::quit);
 
-  connect(&limitTimer, &QTimer::timeout, &limiter, &QEventLoop::quit);
-  limitTimer.setInterval(10000); // 10 second request limit
-  limitTimer.setSingleShot(false);
-  limitTimer.start();
-  
   baseUrl = "https://api.mobygames.com";
 
   searchUrlPre = "https://api.mobygames.com/v1/games";
@@ -58,7 +54,7 @@ void MobyGames::getSearchResults(QList<GameEntry> &gameEntries,
 				QString searchName, QString platform)
 {
   printf("Waiting as advised by MobyGames api restrictions...\n");
-  limiter.exec();
+  RateLimiter::acquire(config->scraper);
   manager.request(searchUrlPre + "?api_key=" + StrTools::unMagic("175;229;170;189;188;202;211;117;164;165;185;209;164;234;180;155;199;209;224;231;193;190;173;175") + "&title=" + searchName);
   q.exec();
   data = manager.getData();
@@ -101,7 +97,7 @@ void MobyGames::getSearchResults(QList<GameEntry> &gameEntries,
 void MobyGames::getGameData(GameEntry &game)
 {
   printf("Waiting to get game data...\n");
-  limiter.exec();
+  RateLimiter::acquire(config->scraper);
   manager.request(game.url);
   q.exec();
   data = manager.getData();
@@ -288,7 +284,7 @@ void MobyGames::getRating(GameEntry &game)
 void MobyGames::getCover(GameEntry &game)
 {
   printf("Waiting to get cover data...\n");
-  limiter.exec();
+  RateLimiter::acquire(config->scraper);
   manager.request(game.url.left(game.url.indexOf("?api_key=")) + "/covers" + game.url.mid(game.url.indexOf("?api_key="), game.url.length() - game.url.indexOf("?api_key=")));
   q.exec();
   data = manager.getData();
@@ -333,7 +329,7 @@ void MobyGames::getCover(GameEntry &game)
 void MobyGames::getScreenshot(GameEntry &game)
 {
   printf("Waiting to get screenshot data...\n");
-  limiter.exec();
+  RateLimiter::acquire(config->scraper);
   manager.request(game.url.left(game.url.indexOf("?api_key=")) + "/screenshots" + game.url.mid(game.url.indexOf("?api_key="), game.url.length() - game.url.indexOf("?api_key=")));
   q.exec();
   data = manager.getData();
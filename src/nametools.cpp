@@ -437,6 +437,27 @@ QString NameTools::getSha1(const QFileInfo &info)
 {
   QCryptographicHash sha1(QCryptographicHash::Sha1);
 
+  if(isSha1FromData(info)) {
+    QFile romFile(info.absoluteFilePath());
+    if(romFile.open(QIODevice::ReadOnly)) {
+      while(!romFile.atEnd()) {
+	sha1.addData(romFile.read(1024));
+      }
+      romFile.close();
+    } else {
+      printf("Couldn't calculate sha1 hash sum of rom file '%s', please check permissions and try again, now exiting...\n", info.fileName().toStdString().c_str());
+      exit(1);
+    }
+  } else {
+    sha1.addData(info.fileName().toUtf8());
+  }
+
+  return sha1.result().toHex();
+}
+
+// Whether the cache sha1 of the file is calculated from its data rather than its filename
+bool NameTools::isSha1FromData(const QFileInfo &info)
+{
   // If file is some sort of script or zip use filename for sha1
   bool sha1FromData = true;
   // In case I look at this code again and think "hey, no reason to have zip there", just a
@@ -461,21 +482,6 @@ QString NameTools::getSha1(const QFileInfo &info)
   if(info.size() == 0) {
     sha1FromData = false;
   }
-  
-  if(sha1FromData) {
-    QFile romFile(info.absoluteFilePath());
-    if(romFile.open(QIODevice::ReadOnly)) {
-      while(!romFile.atEnd()) {
-	sha1.addData(romFile.read(1024));
-      }
-      romFile.close();
-    } else {
-      printf("Couldn't calculate sha1 hash sum of rom file '%s', please check permissions and try again, now exiting...\n", info.fileName().toStdString().c_str());
-      exit(1);
-    }
-  } else {
-    sha1.addData(info.fileName().toUtf8());
-  }
 
-  return sha1.result().toHex();
+  return sha1FromData;
 }
@@ -45,6 +45,7 @@ public:
   static QString getSqrNotes(QString baseName);
   static QString getParNotes(QString baseName);
   static QString getSha1(const QFileInfo &info);
+  static bool isSha1FromData(const QFileInfo &info);
 
 };
 
@@ -24,12 +24,18 @@
  */
 
 #include "netcomm.h"
+#include "ratelimiter.h"
 
 #include <QUrl>
 #include <QNetworkRequest>
+#include <QEventLoop>
+#include <QSharedPointer>
 
 #define MAXSIZE 42000000
 
+QAtomicInt NetComm::requestCount;
+QAtomicInt NetComm::errorCount;
+
 NetComm::NetComm()
 {
   requestTimer.setSingleShot(true);
@@ -37,7 +43,9 @@ NetComm::NetComm()
   connect(&requestTimer, &QTimer::timeout, this, &NetComm::requestTimeout);
 }
 
-void NetComm::request(QString query, QString postData, QString headerKey, QString headerValue)
+QNetworkReply *NetComm::sendRequest(const QString &query, const QString &postData,
+				    const QString &headerKey, const QString &headerValue,
+				    const bool &allowHttp2)
 {
   QUrl url(query);
   QNetworkRequest request(url);
@@ -46,20 +54,119 @@ void NetComm::request(QString query, QString postData, QString headerKey, QStrin
   if(!headerKey.isEmpty() && !headerValue.isEmpty()) {
     request.setRawHeader(headerKey.toUtf8(), headerValue.toUtf8());
   }
+#if QT_VERSION >= 0x050800
+  // Lets concurrent requests to the same host share a single connection where supported
+  request.setAttribute(QNetworkRequest::HTTP2AllowedAttribute, allowHttp2);
+#else
+  Q_UNUSED(allowHttp2);
+#endif
   
   if(postData.isEmpty()) {
-    reply = get(request);
-  } else {
-    reply = post(request, postData.toUtf8());
+    return get(request);
   }
+  return post(request, postData.toUtf8());
+}
+
+void NetComm::request(QString query, QString postData, QString headerKey, QString headerValue)
+{
+  reply = sendRequest(query, postData, headerKey, headerValue);
   connect(reply, &QNetworkReply::finished, this, &NetComm::replyReady);
   connect(reply, &QNetworkReply::downloadProgress, this, &NetComm::dataDownloaded);
   requestTimer.start();
 }
 
+void NetComm::requestAsync(QString query, std::function<void(const NetReply &reply)> callback,
+			   QString postData, QString headerKey, QString headerValue,
+			   const int &reqClass)
+{
+  QNetworkReply *asyncReply = sendRequest(query, postData, headerKey, headerValue, true);
+  pending++;
+
+  // Each reply gets its own timeout timer. It is deleted along with the reply. It's restarted
+  // whenever data arrives, so it only aborts replies that have stalled. Throttled downloads
+  // can take a lot longer than the timeout in total
+  QTimer *replyTimer = new QTimer(asyncReply);
+  replyTimer->setSingleShot(true);
+  replyTimer->setInterval(60000);
+  connect(replyTimer, &QTimer::timeout, asyncReply, [asyncReply]() {
+      printf("Request timed out, aborting request...\n");
+      asyncReply->abort();
+    });
+
+  // Data read so far for replies that are throttled
+  QSharedPointer<QByteArray> received(new QByteArray);
+  if(RateLimiter::hasBandwidth(reqClass)) {
+    // Only read as much as the budget allows. The rest is left on the connection, so the
+    // server sends it as fast as we read it instead of us buffering the entire download
+    asyncReply->setReadBufferSize(BANDWIDTHCHUNK);
+    QTimer *readTimer = new QTimer(asyncReply);
+    readTimer->setInterval(BANDWIDTHINTERVAL);
+    auto readThrottled = [asyncReply, received, readTimer, replyTimer, reqClass]() {
+      qint64 allowed = RateLimiter::takeBandwidth(reqClass, asyncReply->bytesAvailable());
+      if(allowed > 0) {
+	received->append(asyncReply->read(allowed));
+	replyTimer->start();
+      }
+      // Keep checking for budget while there's still data waiting
+      if(asyncReply->bytesAvailable() > 0) {
+	if(!readTimer->isActive()) {
+	  readTimer->start();
+	}
+      } else {
+	readTimer->stop();
+      }
+    };
+    connect(asyncReply, &QNetworkReply::readyRead, asyncReply, readThrottled);
+    connect(readTimer, &QTimer::timeout, asyncReply, readThrottled);
+  }
+
+  connect(asyncReply, &QNetworkReply::downloadProgress, asyncReply,
+	  [asyncReply, replyTimer](qint64 bytesReceived, qint64) {
+	    replyTimer->start();
+	    if(bytesReceived > MAXSIZE) {
+	      printf("Retrieved data size exceeded maximum of 42 MB, cancelling network request...\n");
+	      asyncReply->abort();
+	    }
+	  });
+  connect(asyncReply, &QNetworkReply::finished, this, [this, asyncReply, callback, received]() {
+      countReply(asyncReply);
+      NetReply result;
+      result.data = *received + asyncReply->readAll();
+      result.contentType = asyncReply->rawHeader("Content-Type");
+      result.redirUrl = asyncReply->rawHeader("Location");
+      result.error = asyncReply->error();
+      asyncReply->deleteLater();
+      pending--;
+      callback(result);
+      // Checked after the callback, since it might have made new requests
+      if(pending == 0) {
+	emit allReady();
+      }
+    });
+  replyTimer->start();
+}
+
+int NetComm::pendingRequests()
+{
+  return pending;
+}
+
+// Blocks until all requests made with requestAsync() are done, including any requests
+// made from their callbacks
+void NetComm::waitForAll()
+{
+  if(pending == 0) {
+    return;
+  }
+  QEventLoop q;
+  connect(this, &NetComm::allReady, &q, &QEventLoop::quit);
+  q.exec();
+}
+
 void NetComm::replyReady()
 {
   requestTimer.stop();
+  countReply(reply);
   data = reply->readAll();
   contentType = reply->rawHeader("Content-Type");;
   redirUrl = reply->rawHeader("Location");
@@ -67,6 +174,29 @@ void NetComm::replyReady()
   emit dataReady();
 }
 
+// Timeouts, connection errors, rate limiting (429) and server errors count as errors. Content
+// errors such as 404 don't, as those are a normal answer for missing media
+void NetComm::countReply(QNetworkReply *reply)
+{
+  requestCount.ref();
+  int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+  if((reply->error() != QNetworkReply::NoError &&
+      reply->error() < QNetworkReply::ContentAccessDenied) ||
+     status == 429 || status >= 500) {
+    errorCount.ref();
+  }
+}
+
+int NetComm::getRequestCount()
+{
+  return requestCount.load();
+}
+
+int NetComm::getErrorCount()
+{
+  return errorCount.load();
+}
+
 QByteArray NetComm::getData()
 {
   return data;
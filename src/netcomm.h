@@ -26,9 +26,30 @@
 #ifndef NETCOMM_H
 #define NETCOMM_H
 
+#include <functional>
+
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
 #include <QTimer>
+#include <QAtomicInt>
+
+// Request classes. Videos can be given their own bandwidth budget, so the large downloads
+// don't slow down the other requests
+#define NET_DEFAULT 0
+#define NET_VIDEO 1
+// Max bytes buffered for a reply in a class with a bandwidth budget, and milliseconds between
+// each check for more budget while data is waiting
+#define BANDWIDTHCHUNK 65536
+#define BANDWIDTHINTERVAL 100
+
+// Result of a request made with requestAsync()
+struct NetReply {
+  QByteArray data;
+  QByteArray contentType;
+  QByteArray redirUrl;
+  // Anything but NoError means 'data' might be incomplete, such as when the request timed out
+  QNetworkReply::NetworkError error = QNetworkReply::NoError;
+};
 
 class NetComm : public QNetworkAccessManager
 {
@@ -41,6 +62,16 @@ public:
   QByteArray getData();
   QByteArray getContentType();
   QByteArray getRedirUrl();
+  // Any number of these can be in flight at the same time. The callback is called from the
+  // thread NetComm lives in once the reply is done, as long as its event loop is running
+  void requestAsync(QString query, std::function<void(const NetReply &reply)> callback,
+		    QString postData = "", QString headerKey = "", QString headerValue = "",
+		    const int &reqClass = NET_DEFAULT);
+  int pendingRequests();
+  void waitForAll();
+  // Process wide number of finished requests and how many of those failed
+  static int getRequestCount();
+  static int getErrorCount();
 
 private slots:
   void replyReady();
@@ -49,8 +80,16 @@ private slots:
 
 signals:
   void dataReady();
+  void allReady();
   
 private:
+  QNetworkReply *sendRequest(const QString &query, const QString &postData,
+			     const QString &headerKey, const QString &headerValue,
+			     const bool &allowHttp2 = false);
+  void countReply(QNetworkReply *reply);
+  static QAtomicInt requestCount;
+  static QAtomicInt errorCount;
+  int pending = 0;
   QTimer requestTimer;
   QByteArray data;
   QByteArray contentType;
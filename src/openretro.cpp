@@ -26,6 +26,7 @@
 #include "openretro.h"
 #include "nametools.h"
 #include "strtools.h"
+#include "ratelimiter.h"
 
 #include <QRegularExpression>
 
@@ -91,9 +92,11 @@ OpenRetro::OpenRetro(Settings *config) : AbstractScraper(config)
 void OpenRetro::getSearchResults(QList<GameEntry> &gameEntries,
 				 QString searchName, QString platform)
 {
+  RateLimiter::acquire(config->scraper);
   manager.request(searchUrlPre + searchName + (searchName.left(6) == "/game/"?"":searchUrlPost));
   q.exec();
   while(!manager.getRedirUrl().isEmpty()) {
+    RateLimiter::acquire(config->scraper);
     manager.request(manager.getRedirUrl());
     q.exec();
   }
@@ -154,6 +157,7 @@ void OpenRetro::getSearchResults(QList<GameEntry> &gameEntries,
 void OpenRetro::getGameData(GameEntry &game)
 {
   if(!game.url.isEmpty()) {
+    RateLimiter::acquire(config->scraper);
     manager.request(game.url);
     q.exec();
     data = manager.getData();
@@ -206,6 +210,7 @@ void OpenRetro::getGameData(GameEntry &game)
       ;
     }
   }
+  waitForMedia();
 }
 
 void OpenRetro::getDescription(GameEntry &game)
@@ -23,33 +23,134 @@
  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA.
  */
 
+#include <QMutexLocker>
+
 #include "queue.h"
 
 Queue::Queue()
 {
+  workerEntries.append(new WorkerEntries());
+}
+
+Queue::~Queue()
+{
+  qDeleteAll(workerEntries);
+}
+
+// Spreads the entries out on the workers. Must be called before the workers are started
+void Queue::setWorkers(const int &workers)
+{
+  QList<QFileInfo> allEntries;
+  foreach(WorkerEntries *current, workerEntries) {
+    allEntries.append(current->entries);
+  }
+  qDeleteAll(workerEntries);
+  workerEntries.clear();
+  for(int a = 0; a < qMax(workers, 1); ++a) {
+    workerEntries.append(new WorkerEntries());
+  }
+  // Deal them out round robin, so the workers together still move through the entries in
+  // the original order (by name or by disk location)
+  for(int a = 0; a < allEntries.length(); ++a) {
+    workerEntries.at(a % workerEntries.length())->entries.append(allEntries.at(a));
+  }
+  nextWorker.store(allEntries.length());
+}
+
+void Queue::append(const QFileInfo &info)
+{
+  pushEntry(info, nextWorker.fetchAndAddOrdered(1));
+}
+
+void Queue::append(const QList<QFileInfo> &infos)
+{
+  foreach(QFileInfo info, infos) {
+    append(info);
+  }
 }
 
-bool Queue::hasEntry()
+void Queue::pushEntry(const QFileInfo &info, const int &worker)
 {
-  queueMutex.lock();
-  if(isEmpty()) {
-    queueMutex.unlock();
+  WorkerEntries *target = workerEntries.at(worker % workerEntries.length());
+  QMutexLocker locker(&target->mutex);
+  target->entries.append(info);
+  entryCount.ref();
+}
+
+bool Queue::takeEntry(QFileInfo &info, const int &worker)
+{
+  if(entryCount.load() <= 0) {
     return false;
   }
-  return true;
+  int own = worker % workerEntries.length();
+  for(int a = 0; a < workerEntries.length(); ++a) {
+    WorkerEntries *current = workerEntries.at((own + a) % workerEntries.length());
+    QMutexLocker locker(&current->mutex);
+    if(current->entries.isEmpty()) {
+      continue;
+    }
+    // Take our own entries from the front, steal from the back of the others
+    if(a == 0) {
+      info = current->entries.takeFirst();
+    } else {
+      info = current->entries.takeLast();
+    }
+    entryCount.deref();
+    return true;
+  }
+  return false;
 }
 
-QFileInfo Queue::takeEntry()
+int Queue::length()
 {
-  QFileInfo info = first();
-  removeFirst();
-  queueMutex.unlock();
-  return info;
+  return entryCount.load();
+}
+
+bool Queue::isEmpty()
+{
+  return entryCount.load() <= 0;
 }
 
 void Queue::clearAll()
 {
-  queueMutex.lock();
-  clear();
-  queueMutex.unlock();
+  foreach(WorkerEntries *current, workerEntries) {
+    QMutexLocker locker(&current->mutex);
+    entryCount.fetchAndAddOrdered(-current->entries.length());
+    current->entries.clear();
+  }
+  QMutexLocker locker(&contentMutex);
+  contentWaiting.clear();
+}
+
+// Returns the state of the content. If it was found, 'foundSha1' is set to the cache sha1 it
+// was scraped under
+int Queue::claimContent(const QString &contentId, const QFileInfo &info, const QString &sha1,
+			QString &foundSha1)
+{
+  QMutexLocker locker(&contentMutex);
+  if(!contentStates.contains(contentId)) {
+    contentStates[contentId] = CONTENT_BUSY;
+    return CONTENT_NEW;
+  }
+  if(contentStates.value(contentId) == CONTENT_BUSY) {
+    // Another thread is currently scraping an identical file. Keep this one aside until
+    // that is done, it is then handed back by releaseContent()
+    contentWaiting.insert(contentId, qMakePair(info, sha1));
+    return CONTENT_BUSY;
+  }
+  foundSha1 = contentSha1s.value(contentId);
+  return contentStates.value(contentId);
+}
+
+// Returns the identical files, along with their own cache sha1, that were put aside while
+// the content was being scraped
+QList<QPair<QFileInfo, QString> > Queue::releaseContent(const QString &contentId,
+							const QString &sha1, const bool &found)
+{
+  QMutexLocker locker(&contentMutex);
+  contentStates[contentId] = (found?CONTENT_FOUND:CONTENT_NOTFOUND);
+  contentSha1s[contentId] = sha1;
+  QList<QPair<QFileInfo, QString> > waiting = contentWaiting.values(contentId);
+  contentWaiting.remove(contentId);
+  return waiting;
 }
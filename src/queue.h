@@ -29,17 +29,56 @@
 #include <QList>
 #include <QFileInfo>
 #include <QMutex>
+#include <QMap>
+#include <QMultiMap>
+#include <QPair>
+#include <QAtomicInt>
 
-class Queue : public QList<QFileInfo>
+// Return values for claimContent()
+#define CONTENT_NEW 0
+#define CONTENT_BUSY 1
+#define CONTENT_FOUND 2
+#define CONTENT_NOTFOUND 3
+
+// Each worker has its own list of entries which it takes from the front of. When it runs
+// dry it steals from the back of the other workers' lists. Each list has its own mutex, so
+// workers never wait on each other unless they are working on the very same list.
+struct WorkerEntries {
+  QMutex mutex;
+  QList<QFileInfo> entries;
+};
+
+class Queue
 {
 public:
   Queue();
-  bool hasEntry();
-  QFileInfo takeEntry();
+  ~Queue();
+  void setWorkers(const int &workers);
+  void append(const QFileInfo &info);
+  void append(const QList<QFileInfo> &infos);
+  bool takeEntry(QFileInfo &info, const int &worker = 0);
+  int length();
+  bool isEmpty();
   void clearAll();
+  int claimContent(const QString &contentId, const QFileInfo &info, const QString &sha1,
+		   QString &foundSha1);
+  QList<QPair<QFileInfo, QString> > releaseContent(const QString &contentId,
+						   const QString &sha1, const bool &found);
   
 private:
-  QMutex queueMutex;
+  QList<WorkerEntries *> workerEntries;
+  QAtomicInt entryCount;
+  QAtomicInt nextWorker;
+
+  // Used to make sure files with identical content are only scraped once. The cache sha1 of
+  // the file that was scraped is kept for each content id, since the cache sha1 of zipped and
+  // large files is made from the filename and differs between otherwise identical files
+  QMutex contentMutex;
+  QMap<QString, int> contentStates;
+  QMap<QString, QString> contentSha1s;
+  QMultiMap<QString, QPair<QFileInfo, QString> > contentWaiting;
+
+  void pushEntry(const QFileInfo &info, const int &worker);
 
 };
 
@@ -0,0 +1,150 @@
+/***************************************************************************
+ *            ratelimiter.cpp
+ *
+ *  Sun Oct 18 15:30:48 UTC 2026
+ ****************************************************************************/
+/*
+ *  This file is part of skyscraper.
+ *
+ *  skyscraper is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  skyscraper is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with skyscraper; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA.
+ */
+
+#include <cmath>
+
+#include <QMutexLocker>
+#include <QEventLoop>
+#include <QTimer>
+
+#include "ratelimiter.h"
+
+QMutex RateLimiter::bucketMutex;
+QMap<QString, TokenBucket> RateLimiter::buckets;
+QElapsedTimer RateLimiter::clock;
+QMap<QString, QSharedPointer<QSemaphore> > RateLimiter::threadSlots;
+QMap<int, TokenBucket> RateLimiter::bandwidthBuckets;
+
+void RateLimiter::setLimit(const QString &module, const double &rate, const int &burst)
+{
+  QMutexLocker locker(&bucketMutex);
+  if(!clock.isValid()) {
+    clock.start();
+  }
+  // Keep the current state if another platform in the same process set the same limit
+  if(buckets.contains(module) && buckets.value(module).rate == rate &&
+     buckets.value(module).burst == qMax(burst, 1)) {
+    return;
+  }
+  TokenBucket bucket;
+  bucket.rate = rate;
+  bucket.burst = qMax(burst, 1);
+  bucket.tokens = bucket.burst;
+  bucket.lastRefill = clock.elapsed();
+  buckets[module] = bucket;
+}
+
+// Blocks until the module is allowed to make another request. Modules without a limit
+// return right away
+void RateLimiter::acquire(const QString &module)
+{
+  qint64 waitTime = 0;
+  {
+    QMutexLocker locker(&bucketMutex);
+    if(!buckets.contains(module)) {
+      return;
+    }
+    TokenBucket &bucket = buckets[module];
+    qint64 now = clock.elapsed();
+    bucket.tokens = qMin(bucket.burst, bucket.tokens + (now - bucket.lastRefill) * bucket.rate / 1000.0);
+    bucket.lastRefill = now;
+    // Take the token right away even if it isn't there yet. The tokens then go negative,
+    // which makes the next threads wait their turn after this one
+    bucket.tokens -= 1.0;
+    if(bucket.tokens < 0.0) {
+      waitTime = (qint64)ceil(-bucket.tokens * 1000.0 / bucket.rate);
+    }
+  }
+  if(waitTime > 0) {
+    // Wait in an event loop so replies to requests that are already in flight are handled
+    QEventLoop waitLoop;
+    QTimer::singleShot(waitTime, &waitLoop, &QEventLoop::quit);
+    waitLoop.exec();
+  }
+}
+
+// Limits how many threads can work on games from the module at the same time across the
+// process. Used when several platforms overlap in batch mode, so they don't add up to more
+// threads than the module allows. The first platform to set it decides the limit
+void RateLimiter::setMaxActive(const QString &module, const int &threads)
+{
+  QMutexLocker locker(&bucketMutex);
+  if(!threadSlots.contains(module)) {
+    threadSlots[module] = QSharedPointer<QSemaphore>(new QSemaphore(qMax(threads, 1)));
+  }
+}
+
+QSharedPointer<QSemaphore> RateLimiter::getThreadSlots(const QString &module)
+{
+  QMutexLocker locker(&bucketMutex);
+  return threadSlots.value(module);
+}
+
+// Limits the combined download speed of all requests in a request class (see 'netcomm.h').
+// A rate of 0 removes the limit
+void RateLimiter::setBandwidth(const int &reqClass, const int &bytesPerSecond)
+{
+  QMutexLocker locker(&bucketMutex);
+  if(!clock.isValid()) {
+    clock.start();
+  }
+  if(bytesPerSecond <= 0) {
+    bandwidthBuckets.remove(reqClass);
+    return;
+  }
+  if(bandwidthBuckets.contains(reqClass) &&
+     bandwidthBuckets.value(reqClass).rate == bytesPerSecond) {
+    return;
+  }
+  // Allow up to a second worth of data at once
+  TokenBucket bucket;
+  bucket.rate = bytesPerSecond;
+  bucket.burst = bytesPerSecond;
+  bucket.tokens = bucket.burst;
+  bucket.lastRefill = clock.elapsed();
+  bandwidthBuckets[reqClass] = bucket;
+}
+
+bool RateLimiter::hasBandwidth(const int &reqClass)
+{
+  QMutexLocker locker(&bucketMutex);
+  return bandwidthBuckets.contains(reqClass);
+}
+
+// Returns how many of the 'wanted' bytes can be read right now. Never blocks
+qint64 RateLimiter::takeBandwidth(const int &reqClass, const qint64 &wanted)
+{
+  QMutexLocker locker(&bucketMutex);
+  if(!bandwidthBuckets.contains(reqClass)) {
+    return wanted;
+  }
+  TokenBucket &bucket = bandwidthBuckets[reqClass];
+  qint64 now = clock.elapsed();
+  bucket.tokens = qMin(bucket.burst, bucket.tokens + (now - bucket.lastRefill) * bucket.rate / 1000.0);
+  bucket.lastRefill = now;
+  qint64 allowed = qMin(wanted, (qint64)bucket.tokens);
+  if(allowed > 0) {
+    bucket.tokens -= allowed;
+  }
+  return qMax(allowed, (qint64)0);
+}
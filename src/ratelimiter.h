@@ -0,0 +1,82 @@
+/***************************************************************************
+ *            ratelimiter.h
+ *
+ *  Sun Oct 18 15:30:48 UTC 2026
+ ****************************************************************************/
+/*
+ *  This file is part of skyscraper.
+ *
+ *  skyscraper is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  skyscraper is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with skyscraper; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA.
+ */
+
+#ifndef RATELIMITER_H
+#define RATELIMITER_H
+
+#include <QMap>
+#include <QString>
+#include <QMutex>
+#include <QElapsedTimer>
+#include <QSemaphore>
+#include <QSharedPointer>
+
+struct TokenBucket {
+  double rate = 1.0;
+  double burst = 1.0;
+  double tokens = 1.0;
+  qint64 lastRefill = 0;
+};
+
+// Process wide request limits per scraping module and bandwidth budgets per request class,
+// shared by all threads
+class RateLimiter
+{
+public:
+  static void setLimit(const QString &module, const double &rate, const int &burst);
+  static void acquire(const QString &module);
+  static void setMaxActive(const QString &module, const int &threads);
+  static QSharedPointer<QSemaphore> getThreadSlots(const QString &module);
+  static void setBandwidth(const int &reqClass, const int &bytesPerSecond);
+  static bool hasBandwidth(const int &reqClass);
+  static qint64 takeBandwidth(const int &reqClass, const qint64 &wanted);
+
+private:
+  static QMutex bucketMutex;
+  static QMap<QString, TokenBucket> buckets;
+  static QElapsedTimer clock;
+  static QMap<QString, QSharedPointer<QSemaphore> > threadSlots;
+  static QMap<int, TokenBucket> bandwidthBuckets;
+
+};
+
+// Holds one of the module's thread slots for as long as it exists. Does nothing for modules
+// without a limit on active threads
+class ModuleSlot
+{
+public:
+  ModuleSlot(const QString &module) : semaphore(RateLimiter::getThreadSlots(module)) {
+    if(!semaphore.isNull())
+      semaphore->acquire();
+  };
+  ~ModuleSlot() {
+    if(!semaphore.isNull())
+      semaphore->release();
+  };
+
+private:
+  QSharedPointer<QSemaphore> semaphore;
+
+};
+
+#endif // RATELIMITER_H
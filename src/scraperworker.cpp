@@ -25,12 +25,12 @@
 
 #include <iostream>
 #include <QTimer>
+#include <QElapsedTimer>
 
 #include "scraperworker.h"
 #include "strtools.h"
 #include "nametools.h"
 #include "settings.h"
-#include "compositor.h"
 
 #include "openretro.h"
 #include "thegamesdb.h"
@@ -42,14 +42,32 @@
 #include "importscraper.h"
 #include "arcadedb.h"
 #include "esgamelist.h"
-
-ScraperWorker::ScraperWorker(QSharedPointer<Queue> queue, QSharedPointer<Cache> cache,
-			     Settings config, QString threadId)
+#include "fakescraper.h"
+#include "ratelimiter.h"
+#include "memoryguard.h"
+
+QMutex ScraperWorker::promptMutex;
+
+ScraperWorker::ScraperWorker(QSharedPointer<Queue> queue,
+			     QSharedPointer<BoundedQueue<HashedEntry> > hashedQueue,
+			     QSharedPointer<Cache> cache,
+			     QSharedPointer<Compositor> compositor,
+			     QSharedPointer<QThreadPool> compositorPool,
+			     QSharedPointer<ThreadGovernor> governor,
+			     QList<QSharedPointer<FrontendOutput> > outputs,
+			     Settings config, QString threadId,
+			     QSharedPointer<BoundedQueue<VideoJob> > videoQueue)
 {
   this->config = config;
   this->cache = cache;
+  this->compositor = compositor;
+  this->compositorPool = compositorPool;
+  this->governor = governor;
+  this->outputs = outputs;
   this->queue = queue;
+  this->hashedQueue = hashedQueue;
   this->threadId = threadId;
+  this->videoQueue = videoQueue;
 }
 
 ScraperWorker::~ScraperWorker()
@@ -78,26 +96,84 @@ void ScraperWorker::run()
     scraper = new LocalScraper(&config);
   } else if(config.scraper == "import") {
     scraper = new ImportScraper(&config);
+  } else if(config.scraper == "fake" && config.daemon) {
+    scraper = new FakeScraper(&config);
   } else {
     scraper = new AbstractScraper(&config);
   }
 
   platformOrig = config.platform;
+  scraper->deferVideos = !videoQueue.isNull();
 
-  Compositor compositor(&config);
-  if(!compositor.processXml()) {
-    printf("Something went wrong when parsing artwork xml from '%s', please check the file for errors. Now exiting...\n", config.artworkConfig.toStdString().c_str());
-    exit(1);
-  }
+  // Modules that search by name might still find a file under another name, even if an
+  // identical file wasn't found. Only ScreenScraper looks up the file by its checksums
+  bool shareNotFound = (config.scraper == "screenscraper");
+
+  // Artwork is composited on a shared pool. Limit how many games this thread can have waiting
+  // there, since each of them holds all of its images in memory
+  maxCompositorJobs = qMax(1, compositorPool->maxThreadCount() * 2);
+  compositorSlots.release(maxCompositorJobs);
   
-  while(queue->hasEntry()) {
-    // takeEntry() also unlocks the mutex that was locked in hasEntry()
-    QFileInfo info = queue->takeEntry();
+  // Files arrive here already checksummed by the hash workers
+  HashedEntry hashedEntry;
+  QElapsedTimer gameTimer;
+  forever {
+    if(!governor.isNull()) {
+      // Report the time spent on the previous game and wait until this thread is allowed
+      // to take on another one
+      if(gameTimer.isValid()) {
+	governor->reportGame(gameTimer.elapsed());
+      }
+      governor->waitForTurn(threadId.toInt());
+    }
+    if(MemoryGuard::isOverBudget()) {
+      // The artwork waiting to be composited holds the decoded images, so let it finish first
+      compositorSlots.acquire(maxCompositorJobs);
+      compositorSlots.release(maxCompositorJobs);
+      MemoryGuard::throttle();
+    }
+    // Identical files handed back by releaseContent() are handled by this thread, since the
+    // other threads might have run out of files and quit already
+    if(!identicalEntries.isEmpty()) {
+      hashedEntry = identicalEntries.takeFirst();
+    } else if(!hashedQueue->pop(hashedEntry)) {
+      break;
+    }
+    // When several platforms overlap in batch mode they share the module's threads. The
+    // threads for already cached files don't use the network, so they don't need a slot
+    ModuleSlot moduleSlot(threadId.startsWith("C")?QString():config.scraper);
+    gameTimer.start();
+    QFileInfo info = hashedEntry.info;
+    QString sha1 = hashedEntry.sha1;
+    QString contentId = hashedEntry.contentId;
+    scraper->checksums = hashedEntry.checksums;
     // Reset platform in case we have manipulated it (such as changing 'amiga' to 'cd32')
     config.platform = platformOrig;
-    QString output = "\033[1;33m(T" + threadId + ")\033[0m ";
-    QString debug = "";
-    QString sha1 = NameTools::getSha1(info);
+    ScrapeReport report;
+    pendingVideo = VideoJob();
+    QString &output = report.output;
+    QString &debug = report.debug;
+    output = "\033[1;33m(T" + threadId + ")\033[0m ";
+
+    // Files with identical content are only scraped once. The hash workers leave the content
+    // id empty for files that can only be identified by their filename
+    int contentState = CONTENT_NEW;
+    // The cache sha1 to look up resources from. If an identical file was found, this is the
+    // sha1 it was cached under, which differs from ours if the sha1 is made from the filename
+    QString lookupSha1 = sha1;
+    if(!contentId.isEmpty()) {
+      QString foundSha1;
+      contentState = queue->claimContent(contentId, info, sha1, foundSha1);
+      if(contentState == CONTENT_FOUND) {
+	lookupSha1 = foundSha1;
+      }
+      if(contentState == CONTENT_BUSY) {
+	// An identical file is being scraped by another thread. That thread handles this one
+	// as well when it's done, reusing the result
+	gameTimer.invalidate();
+	continue;
+      }
+    }
 
     QString compareTitle = scraper->getCompareTitle(info);
 
@@ -130,10 +206,11 @@ void ScraperWorker::run()
       gameEntries.append(localGame);
     } else {
       if(config.scraper != "cache" &&
-	 cache->hasEntries(sha1, config.scraper) && !config.refresh) {
+	 cache->hasEntries(lookupSha1, config.scraper) &&
+	 (!config.refresh || contentState == CONTENT_FOUND)) {
 	fromCache = true;
 	GameEntry localGame;
-	localGame.sha1 = sha1;
+	localGame.sha1 = lookupSha1;
 	cache->fillBlanks(localGame, config.scraper);
 	if(localGame.title.isEmpty()) {
 	  localGame.title = compareTitle;
@@ -142,6 +219,8 @@ void ScraperWorker::run()
 	  localGame.platform = config.platform;
 	}
 	gameEntries.append(localGame);
+      } else if(contentState == CONTENT_NOTFOUND && shareNotFound) {
+	debug.append("A file with identical content was not found, skipping search\n");
       } else {
 	scraper->runPasses(gameEntries, info, output, debug);
       }
@@ -157,13 +236,26 @@ void ScraperWorker::run()
     int lowestDistance = 666;
     // Create the game entry we use for the rest of the process
     GameEntry game;
+    bool prefetched = false;
     if(gameEntries.isEmpty()) {
       game.title = compareTitle;
       game.found = false;
     } else {
       game = getBestEntry(gameEntries, compareTitle, lowestDistance);
       if(config.interactive && !fromCache) {
-	game = getEntryFromUser(gameEntries, game, compareTitle, lowestDistance);
+	// The data for Skyscraper's own choice is fetched before asking, while the user is
+	// still deciding on a file from another thread. It's then ready if the user accepts it
+	fetchGameData(game);
+	prefetched = true;
+	promptMutex.lock();
+	GameEntry chosenGame = getEntryFromUser(gameEntries, game, compareTitle, lowestDistance);
+	promptMutex.unlock();
+	// Lets Skyscraper print the output it has held back while the prompt was shown
+	emit promptDone();
+	if(chosenGame.title != game.title || chosenGame.url != game.url) {
+	  game = chosenGame;
+	  prefetched = false;
+	}
       }
     }
     // Fill it with additional needed data
@@ -174,9 +266,12 @@ void ScraperWorker::run()
     if(game.found == false) {
       output.append("\033[1;33m---- Game '" + info.completeBaseName() + "' not found :( ----\033[0m\n\n");
       game.resetMedia();
+      if(contentState == CONTENT_NEW && !contentId.isEmpty())
+	releaseIdentical(contentId, sha1, false);
       if(!forceEnd)
-	forceEnd = limitReached(output);
-      emit entryReady(game, output, debug);
+	forceEnd = limitReached(report.limitOutput);
+      emit entryReady(game, report);
+      emitOutputEntries(game);
       if(forceEnd) {
 	break;
       } else {
@@ -190,9 +285,12 @@ void ScraperWorker::run()
       output.append("\033[1;33m---- Game '" + info.completeBaseName() + "' match too low :| ----\033[0m\n\n");
       game.found = false;
       game.resetMedia();
+      if(contentState == CONTENT_NEW && !contentId.isEmpty())
+	releaseIdentical(contentId, sha1, false);
       if(!forceEnd)
-	forceEnd = limitReached(output);
-      emit entryReady(game, output, debug);
+	forceEnd = limitReached(report.limitOutput);
+      emit entryReady(game, report);
+      emitOutputEntries(game);
       if(forceEnd) {
 	break;
       } else {
@@ -202,39 +300,35 @@ void ScraperWorker::run()
 
     output.append("\033[1;34m---- Game '" + info.completeBaseName() + "' found! :) ----\033[0m\n");
     
-    if(!fromCache) {
-      scraper->getGameData(game);
+    if(!fromCache && !prefetched) {
+      fetchGameData(game);
     }
 
+    bool composite = false;
     if(!config.pretend && config.scraper == "cache") {
-      // Process all artwork
-      compositor.saveAll(game, info.completeBaseName());
-      if(config.videos && game.videoFormat != "") {
-	QString videoDst = config.videosFolder + "/" + info.completeBaseName() + "." + game.videoFormat;
-	QFile videoFileDst(videoDst);
-	if(videoFileDst.exists()) {
-	  // Try to remove existing video destination file first
-	  videoFileDst.remove();
-	}
-	if(config.symlink && config.scraper == "cache" && !game.videoFile.isEmpty()) {
-	  QFile videoFile(game.videoFile);
-	  if(videoFile.exists())
-	    videoFile.link(videoDst);
-	} else {
-	  QFile videoFile(videoDst);
-	  if(videoFile.open(QIODevice::WriteOnly)) {
-	    videoFile.write(game.videoData);
-	    videoFile.close();
-	  }
-	}
+      // Artwork is processed on the compositor pool once we're done with the entry below
+      composite = true;
+      saveVideo(game, config.videosFolder, info.completeBaseName());
+      // Any additional frontends get their own copy of the video
+      foreach(QSharedPointer<FrontendOutput> output, outputs) {
+	saveVideo(game, output->config.videosFolder, info.completeBaseName());
       }
     }
 
-    // Add all resources to the cache
-    if(config.scraper != "cache" && game.found && !fromCache) {
+    // Add all resources to the cache. Resources taken from an identical file with another
+    // sha1 are added under our own sha1 as well, so later runs find them for this file too
+    if(config.scraper != "cache" && game.found && (!fromCache || lookupSha1 != sha1)) {
       game.source = config.scraper;
       cache->addResources(game, config);
+      if(!pendingVideo.game.isNull()) {
+	pendingVideo.game->sha1 = game.sha1;
+	videoQueue->push(pendingVideo);
+	report.videoQueued = true;
+      }
     }
+    // Resources are in the cache now, so identical files can be handled from there
+    if(contentState == CONTENT_NEW && !contentId.isEmpty())
+      releaseIdentical(contentId, sha1, true);
 
     // We're done saving the raw data at this point, so feel free to manipulate game resources to better suit game list creation from here on out.
 
@@ -271,52 +365,130 @@ void ScraperWorker::run()
     // Make sure we have the correct format of 'ages'
     game.ages = StrTools::conformAges(game.ages);
 
-    output.append("Scraper:        " + config.scraper + "\n");
-    if(config.scraper != "cache" && config.scraper != "import") {
-      output.append("From cache:     " + QString((fromCache?"YES (refresh from source with '--cache refresh')":"NO")) + "\n");
-      output.append("Search match:   " + QString::number(searchMatch) + " %\n");
-      output.append("Compare title:  '\033[1;32m" + compareTitle + "\033[0m'\n");
-      output.append("Result title:   '\033[1;32m" + game.title + "\033[0m' (" + game.titleSrc + ")\n");
-    } else {
-      output.append("Title:          '\033[1;32m" + game.title + "\033[0m' (" + game.titleSrc + ")\n");
-    }
+    report.fromCache = fromCache;
+    report.compareTitle = compareTitle;
+    report.resultTitle = game.title;
     if(config.forceFilename) {
       game.title = StrTools::xmlUnescape(StrTools::stripBrackets(info.completeBaseName()));
     }
-    output.append("Platform:       '\033[1;32m" + game.platform + "\033[0m' (" + game.platformSrc + ")\n");
-    output.append("Release Date:   '\033[1;32m");
-    if(game.releaseDate.isEmpty()) {
-      output.append("\033[0m' ()\n");
-    } else {
-      output.append(QDate::fromString(game.releaseDate, "yyyyMMdd").toString("yyyy-MM-dd") + "\033[0m' (" + game.releaseDateSrc + ")\n");
-    }
-    output.append("Developer:      '\033[1;32m" + game.developer + "\033[0m' (" + game.developerSrc + ")\n");
-    output.append("Publisher:      '\033[1;32m" + game.publisher + "\033[0m' (" + game.publisherSrc + ")\n");
-    output.append("Players:        '\033[1;32m" + game.players + "\033[0m' (" + game.playersSrc + ")\n");
-    output.append("Ages:           '\033[1;32m" + game.ages + (game.ages.toInt() != 0?"+":"") + "\033[0m' (" + game.agesSrc + ")\n");
-    output.append("Tags:           '\033[1;32m" + game.tags + "\033[0m' (" + game.tagsSrc + ")\n");
-    output.append("Rating (0-1):   '\033[1;32m" + game.rating + "\033[0m' (" + game.ratingSrc + ")\n");
-    output.append("Cover:          " + QString((game.coverData.isNull()?"\033[1;31mNO":"\033[1;32mYES")) + "\033[0m" + QString((config.cacheCovers?"":" (uncached)")) + " (" + game.coverSrc + ")\n");
-    output.append("Screenshot:     " + QString((game.screenshotData.isNull()?"\033[1;31mNO":"\033[1;32mYES")) + "\033[0m" + QString((config.cacheScreenshots?"":" (uncached)")) + " (" + game.screenshotSrc + ")\n");
-    output.append("Wheel:          " + QString((game.wheelData.isNull()?"\033[1;31mNO":"\033[1;32mYES")) + "\033[0m" + QString((config.cacheWheels?"":" (uncached)")) + " (" + game.wheelSrc + ")\n");
-    output.append("Marquee:        " + QString((game.marqueeData.isNull()?"\033[1;31mNO":"\033[1;32mYES")) + "\033[0m" + QString((config.cacheMarquees?"":" (uncached)")) + " (" + game.marqueeSrc + ")\n");
-    if(config.videos) {
-      output.append("Video:          " + QString((game.videoFormat.isEmpty()?"\033[1;31mNO":"\033[1;32mYES")) + "\033[0m" + QString((game.videoData.size() <= config.videoSizeLimit?"":" (size exceeded, uncached)")) + " (" + game.videoSrc + ")\n");
-    }
-    output.append("\nDescription: (" + game.descriptionSrc + ")\n'\033[1;32m" + game.description.left(config.maxLength) + "\033[0m'\n");
+    report.completeness = game.completeness(config.videos);
+    report.cover = !game.coverData.isNull();
+    report.screenshot = !game.screenshotData.isNull();
+    report.wheel = !game.wheelData.isNull();
+    report.marquee = !game.marqueeData.isNull();
+    report.video = !game.videoFormat.isEmpty();
+    report.videoExceeded = (game.videoData.size() > config.videoSizeLimit);
 
     if(!forceEnd)
-      forceEnd = limitReached(output);
-    emit entryReady(game, output, debug);
+      forceEnd = limitReached(report.limitOutput);
+    // The media data has been saved to disk at this point, so only the metadata and file paths
+    // are sent on to Skyscraper (see GameEntry::stripForList())
+    if(composite) {
+      startOutputJobs(game, info.completeBaseName());
+      compositorSlots.acquire();
+      compositorPool->start(new CompositorJob(compositor.data(), game, info.completeBaseName(),
+					      [this, report](GameEntry &game) {
+						game.stripForList();
+						emit entryReady(game, report);
+						compositorSlots.release();
+					      }));
+    } else {
+      game.stripForList();
+      emit entryReady(game, report);
+    }
     if(forceEnd) {
       break;
     }
   }
+  // Release any threads the governor is holding back, so they can see there's nothing left
+  if(!governor.isNull()) {
+    governor->finish();
+  }
+  // Wait for this thread's compositing jobs to finish before reporting back
+  compositorSlots.acquire(maxCompositorJobs);
+  if(!videoQueue.isNull()) {
+    videoQueue->producerDone();
+  }
 
   delete scraper;
   emit allDone();
 }
 
+// When there's a video queue, the videos are left for the video threads. The game data is
+// then fetched into a copy the video handlers can write to after this thread has moved on
+void ScraperWorker::fetchGameData(GameEntry &game)
+{
+  if(videoQueue.isNull()) {
+    scraper->getGameData(game);
+    scraper->waitForMedia();
+    return;
+  }
+  QSharedPointer<GameEntry> videoGame(new GameEntry(game));
+  scraper->getGameData(*videoGame);
+  scraper->waitForMedia();
+  game = *videoGame;
+  pendingVideo = VideoJob();
+  QList<MediaRequest> requests = scraper->takeVideoRequests();
+  if(!requests.isEmpty()) {
+    // Only the video is needed from here on
+    videoGame->resetMedia();
+    pendingVideo.game = videoGame;
+    pendingVideo.requests = requests;
+  }
+}
+
+void ScraperWorker::saveVideo(const GameEntry &game, const QString &videosFolder,
+			      const QString &baseName)
+{
+  if(!config.videos || game.videoFormat == "") {
+    return;
+  }
+  QString videoDst = videosFolder + "/" + baseName + "." + game.videoFormat;
+  QFile videoFileDst(videoDst);
+  if(videoFileDst.exists()) {
+    // Try to remove existing video destination file first
+    videoFileDst.remove();
+  }
+  if(config.symlink && config.scraper == "cache" && !game.videoFile.isEmpty()) {
+    QFile videoFile(game.videoFile);
+    if(videoFile.exists())
+      videoFile.link(videoDst);
+  } else {
+    QFile videoFile(videoDst);
+    if(videoFile.open(QIODevice::WriteOnly)) {
+      videoFile.write(game.videoData);
+      videoFile.close();
+    }
+  }
+}
+
+// Composites the artwork for each additional frontend using its own artwork definition and
+// media folders. The entries are sent on to Skyscraper once their artwork has been saved
+void ScraperWorker::startOutputJobs(const GameEntry &game, const QString &baseName)
+{
+  for(int a = 0; a < outputs.length(); ++a) {
+    GameEntry outputGame = game;
+    outputGame.videoFile = StrTools::xmlUnescape(outputs.at(a)->config.videosFolder + "/" + baseName + "." + game.videoFormat);
+    compositorSlots.acquire();
+    compositorPool->start(new CompositorJob(outputs.at(a)->compositor.data(), outputGame, baseName,
+					    [this, a](GameEntry &game) {
+					      game.stripForList();
+					      emit outputEntryReady(a, game);
+					      compositorSlots.release();
+					    }));
+  }
+}
+
+void ScraperWorker::emitOutputEntries(const GameEntry &game)
+{
+  if(config.scraper != "cache" || config.pretend) {
+    return;
+  }
+  for(int a = 0; a < outputs.length(); ++a) {
+    emit outputEntryReady(a, game);
+  }
+}
+
 bool ScraperWorker::limitReached(QString &output)
 {
   if(scraper->reqRemaining != -1) { // -1 means there is no limit
@@ -330,6 +502,19 @@ bool ScraperWorker::limitReached(QString &output)
   return false;
 }
 
+void ScraperWorker::releaseIdentical(const QString &contentId, const QString &sha1,
+				     const bool &found)
+{
+  QPair<QFileInfo, QString> waiting;
+  foreach(waiting, queue->releaseContent(contentId, sha1, found)) {
+    HashedEntry entry;
+    entry.info = waiting.first;
+    entry.sha1 = waiting.second;
+    entry.contentId = contentId;
+    identicalEntries.append(entry);
+  }
+}
+
 int ScraperWorker::getSearchMatch(const QString &title, const QString &compareTitle,
 				  const int &lowestDistance)
 {
@@ -29,32 +29,81 @@
 #include <QImage>
 #include <QDir>
 #include <QThread>
+#include <QThreadPool>
+#include <QSemaphore>
+#include <QMutex>
 
 #include "abstractscraper.h"
 #include "settings.h"
 #include "cache.h"
 #include "queue.h"
+#include "hashworker.h"
+#include "compositor.h"
+#include "threadgovernor.h"
+#include "frontendoutput.h"
+#include "videoworker.h"
+
+// Summary of a scraped game used for the console output. The output for found games is
+// assembled from this by Skyscraper when it is printed
+struct ScrapeReport {
+  QString output = "";
+  QString limitOutput = "";
+  QString debug = "";
+  QString compareTitle = "";
+  QString resultTitle = "";
+  bool fromCache = false;
+  int completeness = 0;
+  bool cover = false;
+  bool screenshot = false;
+  bool wheel = false;
+  bool marquee = false;
+  bool video = false;
+  bool videoExceeded = false;
+  bool videoQueued = false;
+};
 
 class ScraperWorker : public QObject
 {
   Q_OBJECT
 
 public:
-  ScraperWorker(QSharedPointer<Queue> queue, QSharedPointer<Cache> cache,
-		Settings config, QString threadId);
+  ScraperWorker(QSharedPointer<Queue> queue,
+		QSharedPointer<BoundedQueue<HashedEntry> > hashedQueue,
+		QSharedPointer<Cache> cache, QSharedPointer<Compositor> compositor,
+		QSharedPointer<QThreadPool> compositorPool,
+		QSharedPointer<ThreadGovernor> governor,
+		QList<QSharedPointer<FrontendOutput> > outputs, Settings config,
+		QString threadId,
+		QSharedPointer<BoundedQueue<VideoJob> > videoQueue = QSharedPointer<BoundedQueue<VideoJob> >());
   ~ScraperWorker();
   void run();
   bool forceEnd = false;
+  // Held while asking the user to choose an entry in interactive mode, so only one thread
+  // asks at a time and nothing else is printed in the middle of it
+  static QMutex promptMutex;
   
 signals:
   void allDone();
-  void entryReady(GameEntry entry, QString output, QString debug);
+  void entryReady(GameEntry entry, ScrapeReport report);
+  void outputEntryReady(int output, GameEntry entry);
+  void promptDone();
   
 private:
   AbstractScraper *scraper;
 
   QSharedPointer<Cache> cache;
   QSharedPointer<Queue> queue;
+  QSharedPointer<BoundedQueue<HashedEntry> > hashedQueue;
+  // Files that were put aside while an identical file was scraped by this thread
+  QList<HashedEntry> identicalEntries;
+  QSharedPointer<Compositor> compositor;
+  QSharedPointer<QThreadPool> compositorPool;
+  QSharedPointer<ThreadGovernor> governor;
+  QList<QSharedPointer<FrontendOutput> > outputs;
+  QSharedPointer<BoundedQueue<VideoJob> > videoQueue;
+  VideoJob pendingVideo;
+  QSemaphore compositorSlots;
+  int maxCompositorJobs = 1;
   
   Settings config;
   QString platformOrig;
@@ -69,6 +118,11 @@ private:
   int getSearchMatch(const QString &title, const QString &compareTitle, const int &lowestDistance);
 
   bool limitReached(QString &output);
+  void releaseIdentical(const QString &contentId, const QString &sha1, const bool &found);
+  void saveVideo(const GameEntry &game, const QString &videosFolder, const QString &baseName);
+  void startOutputJobs(const GameEntry &game, const QString &baseName);
+  void emitOutputEntries(const GameEntry &game);
+  void fetchGameData(GameEntry &game);
 };
 
 #endif // SCRAPERWORKER_H
@@ -24,22 +24,19 @@
  */
 
 #include <QFileInfo>
-#include <QProcess>
 
 #include "screenscraper.h"
 #include "strtools.h"
-#include "crc32.h"
+#include "checksumtools.h"
+#include "ratelimiter.h"
 
 ScreenScraper::ScreenScraper(Settings *config) : AbstractScraper(config)
 {
   connect(&manager, &NetComm::dataReady, &q, &QEventLoop::quit);
 
-  connect(&limitTimer, &QTimer::timeout, &limiter, &QEventLoop::quit);
-  limitTimer.setInterval(1000); // 1 second request limit
-  limitTimer.setSingleShot(false);
-  limitTimer.start();
-
   baseUrl = "http://www.screenscraper.fr";
+  // The media urls are api requests as well
+  limitMedia = true;
 
   fetchOrder.append(PUBLISHER);
   fetchOrder.append(DEVELOPER);
@@ -69,7 +66,7 @@ void ScreenScraper::getSearchResults(QList<GameEntry> &gameEntries,
   QString gameUrl = "https://www.screenscraper.fr/api2/jeuInfos.php?devid=muldjord&devpassword=" + StrTools::unMagic("204;198;236;130;203;181;203;126;191;167;200;198;192;228;169;156") + "&softname=skyscraper" VERSION + (config->user.isEmpty()?"":"&ssid=" + config->user) + (config->password.isEmpty()?"":"&sspassword=" + config->password) + (platformId.isEmpty()?"":"&systemeid=" + platformId) + "&output=xml&" + searchName;
 
   for(int retries = 0; retries < 4; ++retries) {
-    limiter.exec();
+    RateLimiter::acquire(config->scraper);
     manager.request(gameUrl);
     q.exec();
     data = manager.getData();
@@ -186,6 +183,7 @@ void ScreenScraper::getGameData(GameEntry &game)
       ;
     }
   }
+  waitForMedia();
 }
 
 void ScreenScraper::getReleaseDate(GameEntry &game)
@@ -285,21 +283,15 @@ void ScreenScraper::getCover(GameEntry &game)
 {
   QString url = getXmlText("media", REGION, "box-2D");
   if(!url.isEmpty()) {
-    bool moveOn = true;
-    for(int retries = 0; retries < 4; ++retries) {
-      limiter.exec();
-      manager.request(url);
-      q.exec();
-      QImage image;
-      if(image.loadFromData(manager.getData())) {
-	game.coverData = image;
-      } else {
-	if(manager.getData().size() < 1000)
-	  moveOn = false;
-      }
-      if(moveOn)
-	break;
-    }
+    fetchMedia(url, [&game](const NetReply &reply) -> bool {
+	QImage image;
+	if(reply.error == QNetworkReply::NoError && image.loadFromData(reply.data)) {
+	  game.coverData = image;
+	  return true;
+	}
+	// Very small replies are error messages rather than media, so try again
+	return reply.data.size() >= 1000;
+      }, 3);
   }
 }
 
@@ -307,21 +299,15 @@ void ScreenScraper::getScreenshot(GameEntry &game)
 {
   QString url = getXmlText("media", NONE, "ss");
   if(!url.isEmpty()) {
-    bool moveOn = true;
-    for(int retries = 0; retries < 4; ++retries) {
-      limiter.exec();
-      manager.request(url);
-      q.exec();
-      QImage image;
-      if(image.loadFromData(manager.getData())) {
-	game.screenshotData = image;
-      } else {
-	if(manager.getData().size() < 1000)
-	  moveOn = false;
-      }
-      if(moveOn)
-	break;
-    }
+    fetchMedia(url, [&game](const NetReply &reply) -> bool {
+	QImage image;
+	if(reply.error == QNetworkReply::NoError && image.loadFromData(reply.data)) {
+	  game.screenshotData = image;
+	  return true;
+	}
+	// Very small replies are error messages rather than media, so try again
+	return reply.data.size() >= 1000;
+      }, 3);
   }
 }
 
@@ -329,21 +315,15 @@ void ScreenScraper::getWheel(GameEntry &game)
 {
   QString url = getXmlText("media", REGION, "wheel;wheel-hd");
   if(!url.isEmpty()) {
-    bool moveOn = true;
-    for(int retries = 0; retries < 4; ++retries) {
-      limiter.exec();
-      manager.request(url);
-      q.exec();
-      QImage image;
-      if(image.loadFromData(manager.getData())) {
-	game.wheelData = image;
-      } else {
-	if(manager.getData().size() < 1000)
-	  moveOn = false;
-      }
-      if(moveOn)
-	break;
-    }
+    fetchMedia(url, [&game](const NetReply &reply) -> bool {
+	QImage image;
+	if(reply.error == QNetworkReply::NoError && image.loadFromData(reply.data)) {
+	  game.wheelData = image;
+	  return true;
+	}
+	// Very small replies are error messages rather than media, so try again
+	return reply.data.size() >= 1000;
+      }, 3);
   }
 }
 
@@ -351,21 +331,15 @@ void ScreenScraper::getMarquee(GameEntry &game)
 {
   QString url = getXmlText("media", REGION, "screenmarquee");
   if(!url.isEmpty()) {
-    bool moveOn = true;
-    for(int retries = 0; retries < 4; ++retries) {
-      limiter.exec();
-      manager.request(url);
-      q.exec();
-      QImage image;
-      if(image.loadFromData(manager.getData())) {
-	game.marqueeData = image;
-      } else {
-	if(manager.getData().size() < 1000)
-	  moveOn = false;
-      }
-      if(moveOn)
-	break;
-    }
+    fetchMedia(url, [&game](const NetReply &reply) -> bool {
+	QImage image;
+	if(reply.error == QNetworkReply::NoError && image.loadFromData(reply.data)) {
+	  game.marqueeData = image;
+	  return true;
+	}
+	// Very small replies are error messages rather than media, so try again
+	return reply.data.size() >= 1000;
+      }, 3);
   }
 }
 
@@ -373,123 +347,39 @@ void ScreenScraper::getVideo(GameEntry &game)
 {
   QString url = getXmlText("media", NONE, "video");
   if(!url.isEmpty()) {
-    bool moveOn = true;
-    for(int retries = 0; retries < 4; ++retries) {
-      limiter.exec();
-      manager.request(url);
-      q.exec();
-      game.videoData = manager.getData();
-      // Make sure received data is actually a video file
-      QByteArray contentType = manager.getContentType();
-      if(contentType.contains("video/") && game.videoData.size() > 4096) {
-	game.videoFormat = contentType.mid(contentType.indexOf("/") + 1,
-					   contentType.length() - contentType.indexOf("/") + 1);
-      } else {
+    fetchMedia(url, [&game](const NetReply &reply) -> bool {
+	game.videoData = reply.data;
+	// Make sure received data is actually a video file
+	QByteArray contentType = reply.contentType;
+	if(reply.error == QNetworkReply::NoError && contentType.contains("video/") &&
+	   game.videoData.size() > 4096) {
+	  game.videoFormat = contentType.mid(contentType.indexOf("/") + 1,
+					     contentType.length() - contentType.indexOf("/") + 1);
+	  return true;
+	}
 	game.videoData = "";
-	moveOn = false;
-      }
-      if(moveOn)
-	break;
-    }
+	return false;
+      }, 3, NET_VIDEO);
   }
 }
 
 QList<QString> ScreenScraper::getSearchNames(const QFileInfo &info)
 {
-  QList<QString> hashList;
-  QCryptographicHash md5(QCryptographicHash::Md5);
-  QCryptographicHash sha1(QCryptographicHash::Sha1);
-  Crc32 crc;
-  crc.initInstance(1);
-
-  bool unpack = config->unpack;
-
-  if(unpack) {
-    // Size limit for "unpack" is set to 8 megs to ensure the pi doesn't run out of memory
-    if((info.suffix() == "7z" || info.suffix() == "zip") && info.size() < 81920000) {
-      // For 7z (7z, zip) unpacked file reading
-      {
-	QProcess decProc;
-	decProc.setReadChannel(QProcess::StandardOutput);
-
-	decProc.start("7z l -so \"" + info.absoluteFilePath() + "\"");
-	if(decProc.waitForFinished(30000)) {
-	  if(decProc.exitStatus() != QProcess::NormalExit) {
-	    printf("Getting file list from compressed file failed, falling back...\n");
-	    unpack = false;
-	  } else if(!decProc.readAllStandardOutput().contains(" 1 files")) {
-	    printf("Compressed file contains more than 1 file, falling back...\n");
-	    unpack = false;
-	  }
-	} else {
-	  printf("Getting file list from compressed file timed out or failed, falling back...\n");
-	  unpack = false;
-	}
-      }
-
-      if(unpack) {
-	QProcess decProc;
-	decProc.setReadChannel(QProcess::StandardOutput);
-
-	decProc.start("7z x -so \"" + info.absoluteFilePath() + "\"");
-	if(decProc.waitForFinished(30000)) {
-	  if(decProc.exitStatus() == QProcess::NormalExit) {
-	    QByteArray allData = decProc.readAllStandardOutput();
-	    md5.addData(allData);
-	    sha1.addData(allData);
-	    crc.pushData(1, allData.data(), allData.length());
-	  } else {
-	    printf("Something went wrong when decompressing file to stdout, falling back...\n");
-	    unpack = false;
-	  }
-	} else {
-	  printf("Decompression process timed out or failed, falling back...\n");
-	  unpack = false;
-	}
-      }
-    } else {
-      printf("File either not a compressed file or exceeds 8 meg size limit, falling back...\n");
-      unpack = false;
-    }
+  // The hash workers usually calculate the checksums before the file gets here
+  RomChecksums romChecksums = checksums;
+  if(!romChecksums.valid) {
+    romChecksums = (config->crcOnly?ChecksumTools::getCrc(info):
+		    ChecksumTools::getChecksums(info, config->unpack));
   }
 
-  if(!unpack) {
-    // For normal file reading
-    QFile romFile(info.absoluteFilePath());
-    romFile.open(QIODevice::ReadOnly);
-    while(!romFile.atEnd()) {
-      
-      QByteArray dataSeg = romFile.read(1024);
-      md5.addData(dataSeg);
-      sha1.addData(dataSeg);
-      crc.pushData(1, dataSeg.data(), dataSeg.length());
-    }
-    romFile.close();
-  }
-
-  QString crcResult = QString::number(crc.releaseInstance(1), 16);
-  while(crcResult.length() < 8) {
-    crcResult.prepend("0");
-  }
-  QString md5Result = md5.result().toHex();
-  while(md5Result.length() < 32) {
-    md5Result.prepend("0");
-  }
-  QString sha1Result = sha1.result().toHex();
-  while(sha1Result.length() < 40) {
-    sha1Result.prepend("0");
-  }
-
-  hashList.append(QUrl::toPercentEncoding(info.fileName()));
-  hashList.append(crcResult.toUpper());
-  hashList.append(md5Result.toUpper());
-  hashList.append(sha1Result.toUpper());
-
   QList<QString> searchNames;
-  if(info.size() != 0) {
-    searchNames.append("romnom=" + hashList.at(0) + "&crc=" + hashList.at(1) + "&md5=" + hashList.at(2) + "&sha1=" + hashList.at(3) + "&romtaille=" + QString::number(info.size()));
+  QString romName = QUrl::toPercentEncoding(info.fileName());
+  if(info.size() == 0 || !romChecksums.valid) {
+    searchNames.append("romnom=" + romName);
+  } else if(romChecksums.md5.isEmpty()) {
+    searchNames.append("romnom=" + romName + "&crc=" + romChecksums.crc.toUpper() + "&romtaille=" + QString::number(romChecksums.size));
   } else {
-    searchNames.append("romnom=" + hashList.at(0));
+    searchNames.append("romnom=" + romName + "&crc=" + romChecksums.crc.toUpper() + "&md5=" + romChecksums.md5.toUpper() + "&sha1=" + romChecksums.sha1.toUpper() + "&romtaille=" + QString::number(romChecksums.size));
   }
 
   return searchNames;
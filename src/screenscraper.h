@@ -44,8 +44,6 @@ public:
   ScreenScraper(Settings *config);
 
 private:
-  QTimer limitTimer;
-  QEventLoop limiter;
   QList<QString> getSearchNames(const QFileInfo &info) override;
   void getSearchResults(QList<GameEntry> &gameEntries, QString searchName, QString) override;
   void getGameData(GameEntry &game) override;
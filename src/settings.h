@@ -36,6 +36,7 @@ struct Settings {
   QString skippedFileString = "";
   QString configFile = "";
   QString frontend = "emulationstation";
+  QList<QString> extraFrontends;
   QString emulator = "";
   QString platform = "";
   QString scraper = "";
@@ -52,6 +53,7 @@ struct Settings {
   int doneThreads = 0;
   int threads = 4;
   bool threadsSet = false;
+  bool autoThreads = false;
   int minMatch = 65;
   bool minMatchSet = false;
   int notFound = 0;
@@ -61,12 +63,27 @@ struct Settings {
   int maxLength = 2500;
   bool videos = false;
   int videoSizeLimit = 42000000;
+  int videoBandwidth = 0;
+  int memBudget = 0;
   bool symlink = false;
   bool brackets = true;
   bool refresh = false;
   QString cacheOptions = "";
   bool noResize = false;
   bool subdirs = true;
+  bool diskOrder = false;
+  int hashThreads = 2;
+  double rateLimit = 0.0;
+  int rateBurst = 0;
+  bool hashBench = false;
+  bool watch = false;
+  bool singlePass = false;
+  bool batch = false;
+  bool daemon = false;
+  int timeBudget = 0;
+  bool resume = false;
+  int shardIndex = 0;
+  int shardCount = 0;
   QString startAt = "";
   QString endAt = "";
   bool pretend = false;
@@ -85,6 +102,7 @@ struct Settings {
   QString extensions = "";
   QString addExtensions = "";
   bool unpack = false;
+  bool crcOnly = false;
   bool preserveOldGameList = true;
   bool spaceCheck = true;
   bool memCheck = true;
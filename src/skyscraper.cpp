@@ -35,27 +35,62 @@
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QSet>
 #if QT_VERSION >= 0x050400
 #include <QStorageInfo>
 #endif
 
 #include "skyscraper.h"
 #include "strtools.h"
+#include "disktools.h"
+#include "hashworker.h"
+#include "ratelimiter.h"
+#include "memoryguard.h"
+#include "threadgovernor.h"
 
 #include "emulationstation.h"
 #include "attractmode.h"
 
-Skyscraper::Skyscraper(const QCommandLineParser &parser, const QString &currentDir)
+bool Skyscraper::filesUpdated = false;
+bool Skyscraper::resourcesLoaded = false;
+QMap<QString, QImage> Skyscraper::sharedResources;
+bool Skyscraper::aliasMapLoaded = false;
+QMap<QString, QString> Skyscraper::sharedAliasMap;
+bool Skyscraper::mameMapLoaded = false;
+QMap<QString, QString> Skyscraper::sharedMameMap;
+bool Skyscraper::whdLoadMapLoaded = false;
+QMap<QString, QPair<QString, QString> > Skyscraper::sharedWhdLoadMap;
+bool Skyscraper::whdLoadFetched = false;
+QSet<QString> Skyscraper::checkedModules;
+QMap<QString, int> Skyscraper::allowedThreads;
+
+QMap<QString, QSharedPointer<Cache> > Skyscraper::sharedCaches;
+
+Skyscraper::Skyscraper(const QCommandLineParser &parser, const QString &currentDir,
+		       const QString &platform, const QString &scraper, const bool &daemon)
 {
   qRegisterMetaType<GameEntry>("GameEntry");
+  qRegisterMetaType<ScrapeReport>("ScrapeReport");
 
   // Randomize timer
   qsrand(QTime::currentTime().msec());
   
-  printf("%s", StrTools::getVersionHeader().toStdString().c_str());
+  // The daemon prints the header once when it starts
+  if(!daemon) {
+    printf("%s", StrTools::getVersionHeader().toStdString().c_str());
+  }
 
   config.currentDir = currentDir;
-  loadConfig(parser);
+  config.daemon = daemon;
+  loadConfig(parser, platform, scraper);
+
+  // Writing the cache is postponed a bit in daemon mode, so a burst of requests only causes
+  // a single write
+  cacheWriteTimer.setSingleShot(true);
+  cacheWriteTimer.setInterval(DAEMONWRITEDELAY);
+  connect(&cacheWriteTimer, &QTimer::timeout, this, &Skyscraper::flushCache);
 }
 
 Skyscraper::~Skyscraper()
@@ -65,150 +100,29 @@ Skyscraper::~Skyscraper()
 
 void Skyscraper::run()
 {
-  printf("Platform:           '\033[1;32m%s\033[0m'\n", config.platform.toStdString().c_str());
-  printf("Scraping module:    '\033[1;32m%s\033[0m'\n", config.scraper.toStdString().c_str());
-  if(!config.emulator.isEmpty()) {
-    printf("Emulator:           '\033[1;32m%s\033[0m'\n", config.emulator.toStdString().c_str());
-  }
-  printf("Input folder:       '\033[1;32m%s\033[0m'\n", config.inputFolder.toStdString().c_str());
-  printf("Game list folder:   '\033[1;32m%s\033[0m'\n", config.gameListFolder.toStdString().c_str());
-  printf("Covers folder:      '\033[1;32m%s\033[0m'\n", config.coversFolder.toStdString().c_str());
-  printf("Screenshots folder: '\033[1;32m%s\033[0m'\n", config.screenshotsFolder.toStdString().c_str());
-  printf("Wheels folder:      '\033[1;32m%s\033[0m'\n", config.wheelsFolder.toStdString().c_str());
-  printf("Marquees folder:    '\033[1;32m%s\033[0m'\n", config.marqueesFolder.toStdString().c_str());
-  if(config.videos) {
-    printf("Videos folder:      '\033[1;32m%s\033[0m'\n", config.videosFolder.toStdString().c_str());
-  }
-  printf("Cache folder:       '\033[1;32m%s\033[0m'\n", config.cacheFolder.toStdString().c_str());
-  if(config.scraper == "import") {
-    printf("Import folder:      '\033[1;32m%s\033[0m'\n", config.importFolder.toStdString().c_str());
-  }
-
-  printf("\n");
-  
-  if(!config.nohints) {
-    showHint();
+  if(config.timeBudget > 0) {
+    budgetTimer.setSingleShot(true);
+    budgetTimer.setInterval(config.timeBudget * 60 * 1000);
+    connect(&budgetTimer, &QTimer::timeout, this, &Skyscraper::budgetReached);
+    budgetTimer.start();
   }
 
-  doPrescrapeJobs();
-  
   doneThreads = 0;
   notFound = 0;
   found = 0;
   avgCompleteness = 0;
   avgSearchMatch = 0;
-  
-  {
-    if(config.unpack) {
-      QProcess decProc;
-      decProc.setReadChannel(QProcess::StandardOutput);
-      decProc.start("which 7z");
-      decProc.waitForFinished(10000);
-      if(!decProc.readAllStandardOutput().contains("7z")) {
-	printf("Couldn't find '7z' command. 7z is required by the '--unpack' option. On Debian derivatives such as RetroPie you can install it with 'sudo apt-get install p7zip-full'.\n\nNow quitting...\n");
-	exit(1);
-      }
-    }
-  }
-  
-  if(!config.cacheFolder.isEmpty()) {
-    cache = QSharedPointer<Cache>(new Cache(config.cacheFolder));
-    if(cache->createFolders(config.scraper)) {
-      if(!cache->read() && config.scraper == "cache") {
-	printf("No resources for this platform found in the resource cache. Please specify a scraping module with '-s' to gather some resources before trying to generate a game list. Check all available modules with '--help'. You can also run Skyscraper in simple mode by typing 'Skyscraper' and follow the instructions on screen.\n\n");
-	exit(1);
-      }
-    } else {
-      printf("Couldn't create cache folders, please check folder permissions and try again...\n");
-      exit(1);
-    }
-  }
-  if(config.verbosity || config.cacheOptions == "show") {
-    cache->showStats(config.cacheOptions == "show"?2:config.verbosity);
-    if(config.cacheOptions == "show")
-      exit(0);
-  }
-  if(config.cacheOptions.contains("purge:") ||
-     config.cacheOptions.contains("vacuum")) {
-    if(config.cacheOptions == "purge:all") {
-      cache->purgeAll(config.unattend || config.unattendSkip);
-    } else if(config.cacheOptions == "vacuum") {
-      cache->vacuumResources(config.inputFolder, Platform::getFormats(config.platform, config.extensions, config.addExtensions), config.verbosity, config.unattend || config.unattendSkip);
-    } else if(config.cacheOptions.contains("purge:m=") ||
-	      config.cacheOptions.contains("purge:t=")) {
-      cache->purgeResources(config.cacheOptions);
-    }
-    cache->write();
-    exit(0);
-  }
-  if(config.cacheOptions.contains("report:")) {
-    cache->assembleReport(config.inputFolder, Platform::getFormats(config.platform,
-								   config.extensions,
-								   config.addExtensions),
-			  config.cacheOptions);
-    exit(0);
-  }
-  if(config.cacheOptions == "validate") {
-    cache->validate();
-    cache->write();
-    exit(0);
-  }
-  if(config.cacheOptions.contains("merge:")) {
-    QFileInfo mergeCacheInfo(config.cacheOptions.replace("merge:", ""));
-    if(mergeCacheInfo.exists()) {
-      Cache mergeCache(mergeCacheInfo.absoluteFilePath());
-      mergeCache.read();
-      cache->merge(mergeCache, config.refresh, mergeCacheInfo.absoluteFilePath());
-      cache->write();
-    } else {
-      printf("Folder to merge from doesn't seem to exist, can't continue...\n");
-    }
-    exit(0);
-  }
-  cache->readPriorities();
-
-  QDir inputDir(config.inputFolder, Platform::getFormats(config.platform, config.extensions, config.addExtensions), QDir::Name, QDir::Files);
-  if(!inputDir.exists()) {
-    printf("Input folder '\033[1;32m%s\033[0m' doesn't exist or can't be seen by current user. Please check path and permissions.\n", inputDir.absolutePath().toStdString().c_str());
-    exit(1);
-  }
-  config.inputFolder = inputDir.absolutePath();
-
-  QDir gameListDir(config.gameListFolder);
-  checkForFolder(gameListDir);
-  config.gameListFolder = gameListDir.absolutePath();
-  
-  QDir coversDir(config.coversFolder);
-  checkForFolder(coversDir);
-  config.coversFolder = coversDir.absolutePath();
-
-  QDir screenshotsDir(config.screenshotsFolder);
-  checkForFolder(screenshotsDir);
-  config.screenshotsFolder = screenshotsDir.absolutePath();
-
-  QDir wheelsDir(config.wheelsFolder);
-  checkForFolder(wheelsDir);
-  config.wheelsFolder = wheelsDir.absolutePath();
-
-  QDir marqueesDir(config.marqueesFolder);
-  checkForFolder(marqueesDir);
-  config.marqueesFolder = marqueesDir.absolutePath();
 
-  if(config.videos) {
-    QDir videosDir(config.videosFolder);
-    checkForFolder(videosDir);
-    config.videosFolder = videosDir.absolutePath();
+  if(!prepare()) {
+    // Let the batch continue with the next platform
+    emit finished();
+    return;
   }
 
-  QDir importDir(config.importFolder);
-  checkForFolder(importDir, false);
-  config.importFolder = importDir.absolutePath();
-  
-  gameListFileString = gameListDir.absolutePath() + "/" + frontend->getGameListFileName();
-
+  QDir inputDir(config.inputFolder, Platform::getFormats(config.platform, config.extensions, config.addExtensions), QDir::Name, QDir::Files);
   QFile gameListFile(gameListFileString);
 
-  // Create shared queue with files to process
+  // Create shared queue. It is filled once the list of files to process is final
   queue = QSharedPointer<Queue>(new Queue());
   QList<QFileInfo> infoList = inputDir.entryInfoList();
   if(!config.startAt.isEmpty() && !infoList.isEmpty()) {
@@ -220,9 +134,11 @@ void Skyscraper::run()
       startAt.setFile(inputDir.absolutePath() + "/" + config.startAt);
     }
     if(startAt.exists()) {
-      while(infoList.first().fileName() != startAt.fileName() && !infoList.isEmpty()) {
-	infoList.removeFirst();
+      int index = 0;
+      while(index < infoList.length() && infoList.at(index).fileName() != startAt.fileName()) {
+	index++;
       }
+      infoList = infoList.mid(index);
     }
   }
   if(!config.endAt.isEmpty() && !infoList.isEmpty()) {
@@ -234,12 +150,13 @@ void Skyscraper::run()
       endAt.setFile(inputDir.absolutePath() + "/" + config.endAt);
     }
     if(endAt.exists()) {
-      while(infoList.last().fileName() != endAt.fileName() && !infoList.isEmpty()) {
-	infoList.removeLast();
+      int index = infoList.length() - 1;
+      while(index >= 0 && infoList.at(index).fileName() != endAt.fileName()) {
+	index--;
       }
+      infoList = infoList.mid(0, index + 1);
     }
   }
-  queue->append(infoList);
   if(config.subdirs) {
     QDirIterator dirIt(config.inputFolder,
 		       QDir::Dirs | QDir::NoDotAndDotDot | QDir::NoSymLinks,
@@ -247,7 +164,7 @@ void Skyscraper::run()
     while(dirIt.hasNext()) {
       QString subdir = dirIt.next();
       inputDir.setPath(subdir);
-      queue->append(inputDir.entryInfoList());
+      infoList.append(inputDir.entryInfoList());
       if(config.verbosity > 0) {
 	printf("Adding files from subdir: '%s'\n", subdir.toStdString().c_str());
       }
@@ -257,20 +174,30 @@ void Skyscraper::run()
   }
 
   if(!cliFiles.isEmpty()) {
-    queue->clear();
+    infoList.clear();
     foreach(QString cliFile, cliFiles) {
-      queue->append(QFileInfo(cliFile));
+      infoList.append(QFileInfo(cliFile));
     }
   } 
 
+  if(config.shardCount > 0) {
+    applyShard(infoList);
+  }
+
+  if(config.hashBench) {
+    runHashBenchmark(infoList);
+    exit(0);
+  }
+
   if(config.cacheOptions == "edit") {
+    queue->append(infoList);
     cache->editResources(queue);
     printf("Done editing resources!\n");
     cache->write();
     exit(0);
   }
 
-  if(!config.pretend && config.scraper == "cache" &&
+  if(!config.pretend && (config.scraper == "cache" || config.singlePass) &&
      !config.unattend && !config.unattendSkip &&
      gameListFile.exists()) {
     std::string userInput = "";
@@ -293,15 +220,17 @@ void Skyscraper::run()
     }
     printf("\n");
   }
-  if(config.pretend && config.scraper == "cache") {
+  if(config.pretend && (config.scraper == "cache" || config.singlePass)) {
     printf("Pretend set! Not changing any files, just showing output.\n\n");
   }
 
-  QFile skippedFile(skippedFileString);
+  // Kept open for the entire run. Skipped games are written to its buffer and it's flushed
+  // once each round is done
+  skippedFile.setFileName(skippedFileString);
   skippedFile.open(QIODevice::WriteOnly);
   skippedFile.write("--- The following is a list of skipped games ---\n");
-  skippedFile.close();
 
+  bool skipExisting = false;
   if(gameListFile.exists()) {
     printf("Trying to parse and load existing game list metadata... ");
     fflush(stdout);
@@ -317,7 +246,8 @@ void Skyscraper::run()
 	    getline(std::cin, userInput);
 	  }
 	  if((userInput == "y" || userInput == "Y") && frontend->canSkip()) {
-	    frontend->skipExisting(gameEntries, queue);
+	    frontend->skipExisting(gameEntries, infoList);
+	    skipExisting = true;
 	  }
 	}
       }
@@ -325,185 +255,942 @@ void Skyscraper::run()
       printf("\033[1;33mNot found or unsupported!\033[0m\n");
     }
   }
+  // The additional frontends follow the main frontend when skipping existing entries. Entries
+  // that are generated anyway replace the old ones when writing the game lists
+  foreach(QSharedPointer<FrontendOutput> output, outputs) {
+    if(QFileInfo::exists(output->gameListFileString) &&
+       output->frontend->loadOldGameList(output->gameListFileString) &&
+       skipExisting && output->frontend->canSkip()) {
+      QList<QFileInfo> emptyQueue;
+      output->frontend->skipExisting(output->gameEntries, emptyQueue);
+    }
+  }
+
+  if(config.timeBudget > 0 || config.resume) {
+    openCheckpoint(infoList);
+  }
+
+  if(config.diskOrder) {
+    // Process files in the order they are located on disk to avoid seeking back and forth
+    // while checksumming. The frontend sorts all entries before writing the game list, so
+    // the game list itself is still in filename order
+    DiskTools::sortByDiskLocation(infoList);
+  }
 
+  queue->append(infoList);
   totalFiles = queue->length();
   
   if(config.romLimit != -1 && totalFiles > config.romLimit) {
     printf("\n\033[1;33mRestriction overrun!\033[0m This scraping module only allows for scraping up to %d roms at a time. You can either supply a few rom filenames on command line, or make use of the '--startat' and / or '--endat' command line options to adhere to this. Please check '--help' for more info.\n\nNow quitting...\n", config.romLimit);
+    if(config.batch) {
+      emit finished();
+      return;
+    }
     exit(0);
   }
 
   if(totalFiles > 0) {
-    printf("\nStarting scraping run on \033[1;32m%d\033[0m files using \033[1;32m%d\033[0m threads.\nSit back, relax and let me do the work! :)\n\n", totalFiles, config.threads);
+    printf("\nStarting scraping run on \033[1;32m%d\033[0m files using %s\033[1;32m%d\033[0m threads.\nSit back, relax and let me do the work! :)\n\n", totalFiles, (config.autoThreads?"up to ":""), config.threads);
   } else {
     printf("\nNo entries to scrape...\n\n");
   }
 
-  timer.start();
-  currentFile = 1;
-
-  QList<QThread*> threadList;
-  for(int curThread = 1; curThread <= config.threads; ++curThread) {
-    QThread *thread = new QThread;
-    ScraperWorker *worker = new ScraperWorker(queue, cache, config, QString::number(curThread));
-    worker->moveToThread(thread);
-    connect(thread, &QThread::started, worker, &ScraperWorker::run);
-    connect(worker, &ScraperWorker::entryReady, this, &Skyscraper::entryReady);
-    connect(worker, &ScraperWorker::allDone, this, &Skyscraper::checkThreads);
-    connect(thread, &QThread::finished, worker, &ScraperWorker::deleteLater);
-    threadList.append(thread);
-    // Do not start more threads if we have less files than allowed threads
-    if(curThread == totalFiles) {
-      config.threads = curThread;
-      break;
-    }
-  }
-  // Ready, set, GO!!! Start all threads
-  foreach(QThread *thread, threadList) {
-    thread->start();
-    threadsRunning = true;
-  }
-}
-
-void Skyscraper::checkForFolder(QDir &folder, bool create)
-{
-  if(!folder.exists()) {
-    printf("Folder '%s' doesn't exist", folder.absolutePath().toStdString().c_str());
-    if(create) {
-      printf(", trying to create it... ");
-      fflush(stdout);
-      if(folder.mkpath(folder.absolutePath())) {
-	printf("\033[1;32mSuccess!\033[0m\n");
-      } else {
-	printf("\033[1;32mFailed!\033[0m Please check path and permissions, now exiting...\n");
-	exit(1);
-      }
-    } else {
-      printf(", can't continue...\n");
-      exit(1);
-    }
-  }
+  watchMode = config.watch;
+  startThreads(config.scraper);
 }
 
-QString Skyscraper::secsToString(const int &secs)
+// Everything that needs to be in place before any files can be scraped. Returns false if
+// this platform can't be scraped, but only when running in batch or daemon mode
+bool Skyscraper::prepare()
 {
-  QString hours = QString::number(secs / 3600000 % 24);
-  QString minutes = QString::number(secs / 60000 % 60);
-  QString seconds = QString::number(secs / 1000 % 60);
-  if(hours.length() == 1) {
-    hours.prepend("0");
+  printf("Platform:           '\033[1;32m%s\033[0m'\n", config.platform.toStdString().c_str());
+  printf("Scraping module:    '\033[1;32m%s\033[0m'\n", config.scraper.toStdString().c_str());
+  if(!config.emulator.isEmpty()) {
+    printf("Emulator:           '\033[1;32m%s\033[0m'\n", config.emulator.toStdString().c_str());
   }
-  if(minutes.length() == 1) {
-    minutes.prepend("0");
+  printf("Input folder:       '\033[1;32m%s\033[0m'\n", config.inputFolder.toStdString().c_str());
+  printf("Game list folder:   '\033[1;32m%s\033[0m'\n", config.gameListFolder.toStdString().c_str());
+  printf("Covers folder:      '\033[1;32m%s\033[0m'\n", config.coversFolder.toStdString().c_str());
+  printf("Screenshots folder: '\033[1;32m%s\033[0m'\n", config.screenshotsFolder.toStdString().c_str());
+  printf("Wheels folder:      '\033[1;32m%s\033[0m'\n", config.wheelsFolder.toStdString().c_str());
+  printf("Marquees folder:    '\033[1;32m%s\033[0m'\n", config.marqueesFolder.toStdString().c_str());
+  if(config.videos) {
+    printf("Videos folder:      '\033[1;32m%s\033[0m'\n", config.videosFolder.toStdString().c_str());
   }
-  if(seconds.length() == 1) {
-    seconds.prepend("0");
+  printf("Cache folder:       '\033[1;32m%s\033[0m'\n", config.cacheFolder.toStdString().c_str());
+  if(config.scraper == "import") {
+    printf("Import folder:      '\033[1;32m%s\033[0m'\n", config.importFolder.toStdString().c_str());
   }
 
-  return hours + ":" + minutes + ":" + seconds;
-}
-
-void Skyscraper::entryReady(GameEntry entry, QString output, QString debug)
-{
-  QMutexLocker locker(&entryMutex);
-
-  printf("\033[0;32m#%d/%d\033[0m %s\n", currentFile, totalFiles, output.toStdString().c_str());
-
-  if(config.verbosity >= 3) {
-    printf("\033[1;33mDebug output:\033[0m\n%s\n", debug.toStdString().c_str());
+  printf("\n");
+  
+  if(!config.nohints) {
+    showHint();
   }
 
-  if(entry.found) {
-    found++;
-    avgCompleteness += entry.completeness(config.videos);
-    avgSearchMatch += entry.searchMatch;
-    // Remove unnecessary media data to save memory before adding it to final entrylist
-    // At this point data has been saved to disc, so we don't need it anymore.
-    entry.resetMedia();
-    gameEntries.append(entry);
-  } else {
-    notFound++;
-    QFile skippedFile(skippedFileString);
-    skippedFile.open(QIODevice::Append);
-    skippedFile.write("'" + entry.baseName.toUtf8() + "'");
-    if(entry.searchMatch == 0) {
-      skippedFile.write(", No returned matches\n");
-    } else {
-      skippedFile.write(", Closest match was '" + entry.title.toUtf8() + "' at " + QByteArray::number(entry.searchMatch) + "%\n");
-    }
-    skippedFile.close();
-    if(config.skipped) {
-      // Remove unnecessary media data to save memory before adding it to final entrylist
-      // At this point data has been saved to disc, so we don't need it anymore.
-      entry.resetMedia();
-      gameEntries.append(entry);
+  doPrescrapeJobs();
+  
+  {
+    if(config.unpack) {
+      QProcess decProc;
+      decProc.setReadChannel(QProcess::StandardOutput);
+      decProc.start("which 7z");
+      decProc.waitForFinished(10000);
+      if(!decProc.readAllStandardOutput().contains("7z")) {
+	printf("\033[1;33mCouldn't find '7z' command. Zip files will still be unpacked, but 7z files and unsupported zip files will be checksummed as they are. On Debian derivatives such as RetroPie you can install it with 'sudo apt-get install p7zip-full'.\033[0m\n\n");
+      }
     }
   }
   
-  printf("\033[1;32m%d\033[0m/\033[1;33m%d\033[0m/\033[1;34m%d\033[0m\n", found, notFound, currentFile);
-  int elapsed = timer.elapsed();
-  int estTime = (elapsed / currentFile * totalFiles) - elapsed;
-  if(estTime < 0)
-    estTime = 0;
-  printf("Elapsed time   : \033[1;33m%s\033[0m\n", secsToString(elapsed).toStdString().c_str());
-  printf("Est. time left : \033[1;33m%s\033[0m\n\n", secsToString(estTime).toStdString().c_str());
-
-  if(currentFile == config.maxFails && notFound == config.maxFails &&
-     config.scraper != "import" && config.scraper != "cache") {
-    printf("\033[1;31mThis is NOT going well! I guit! *slams the door*\nNo, seriously, out of %d files we had %d misses. So either the scraping source is down or you are using a scraping source that doesn't support this platform. Please try another scraping module (check '--help').\n\nNow exiting...\033[0m\n", config.maxFails, config.maxFails);
-    exit(1);
+  if(!config.cacheFolder.isEmpty()) {
+    // In daemon mode all scraping modules for a platform work on the same cache in memory, so
+    // resources scraped by one request are available to the next right away
+    QString cacheKey = QDir(config.cacheFolder).absolutePath();
+    if(config.daemon && sharedCaches.contains(cacheKey)) {
+      cache = sharedCaches.value(cacheKey);
+      if(!cache->createFolders(config.scraper)) {
+	printf("Couldn't create cache folders, please check folder permissions and try again...\n");
+	return false;
+      }
+    } else {
+      cache = QSharedPointer<Cache>(new Cache(config.cacheFolder));
+      if(cache->createFolders(config.scraper)) {
+	if(!cache->read() && config.scraper == "cache" && !config.daemon) {
+	  printf("No resources for this platform found in the resource cache. Please specify a scraping module with '-s' to gather some resources before trying to generate a game list. Check all available modules with '--help'. You can also run Skyscraper in simple mode by typing 'Skyscraper' and follow the instructions on screen.\n\n");
+	  if(config.batch) {
+	    return false;
+	  }
+	  exit(1);
+	}
+      } else {
+	printf("Couldn't create cache folders, please check folder permissions and try again...\n");
+	if(config.daemon) {
+	  return false;
+	}
+	exit(1);
+      }
+      if(config.daemon) {
+	sharedCaches[cacheKey] = cache;
+      }
+    }
   }
-  currentFile++;
-
-#if QT_VERSION >= 0x050400
-  qint64 spaceLimit = 209715200;
-  if(config.spaceCheck && (QStorageInfo(QDir(config.mediaFolder)).bytesFree() < spaceLimit ||
-			   QStorageInfo(QDir::current()).bytesFree() < spaceLimit)) {
-    printf("\033[1;31mYou have very little disk space left either on the Skyscraper resource cache drive or on the game list and media export drive, please free up some space and try again. Now aborting...\033[0m\n\nNote! You can disable this check by setting 'spaceCheck=\"false\"' in the '[main]' section of config.ini.\n\n");
+  if(config.verbosity || config.cacheOptions == "show") {
+    cache->showStats(config.cacheOptions == "show"?2:config.verbosity);
+    if(config.cacheOptions == "show")
+      exit(0);
+  }
+  if(config.cacheOptions.contains("purge:") ||
+     config.cacheOptions.contains("vacuum")) {
+    if(config.cacheOptions == "purge:all") {
+      cache->purgeAll(config.unattend || config.unattendSkip);
+    } else if(config.cacheOptions == "vacuum") {
+      cache->vacuumResources(config.inputFolder, Platform::getFormats(config.platform, config.extensions, config.addExtensions), config.verbosity, config.unattend || config.unattendSkip);
+    } else if(config.cacheOptions.contains("purge:m=") ||
+	      config.cacheOptions.contains("purge:t=")) {
+      cache->purgeResources(config.cacheOptions);
+    }
+    cache->write();
+    exit(0);
+  }
+  if(config.cacheOptions.contains("report:")) {
+    cache->assembleReport(config.inputFolder, Platform::getFormats(config.platform,
+								   config.extensions,
+								   config.addExtensions),
+			  config.cacheOptions);
+    exit(0);
+  }
+  if(config.cacheOptions == "validate") {
+    cache->validate();
+    cache->write();
+    exit(0);
+  }
+  if(config.cacheOptions.contains("merge:")) {
+    // Several folders can be merged in one go, such as the caches from each '--shard'
+    foreach(QString mergeFolder, config.cacheOptions.replace("merge:", "").split(",", QString::SkipEmptyParts)) {
+      QFileInfo mergeCacheInfo(mergeFolder);
+      if(mergeCacheInfo.exists()) {
+	printf("Merging '%s'...\n", mergeCacheInfo.absoluteFilePath().toStdString().c_str());
+	Cache mergeCache(mergeCacheInfo.absoluteFilePath());
+	mergeCache.read();
+	cache->merge(mergeCache, config.refresh, mergeCacheInfo.absoluteFilePath());
+      } else {
+	printf("Folder '%s' to merge from doesn't seem to exist, skipping...\n", mergeFolder.toStdString().c_str());
+      }
+    }
+    cache->write();
+    exit(0);
+  }
+  cache->readPriorities();
+
+  QDir inputDir(config.inputFolder);
+  // The daemon is given the files with each request, so it doesn't need the input folder
+  if(!inputDir.exists() && !config.daemon) {
+    printf("Input folder '\033[1;32m%s\033[0m' doesn't exist or can't be seen by current user. Please check path and permissions.\n", inputDir.absolutePath().toStdString().c_str());
+    if(config.batch) {
+      return false;
+    }
+    exit(1);
+  }
+  config.inputFolder = inputDir.absolutePath();
+
+  QDir gameListDir(config.gameListFolder);
+  checkForFolder(gameListDir);
+  config.gameListFolder = gameListDir.absolutePath();
+  
+  QDir coversDir(config.coversFolder);
+  checkForFolder(coversDir);
+  config.coversFolder = coversDir.absolutePath();
+
+  QDir screenshotsDir(config.screenshotsFolder);
+  checkForFolder(screenshotsDir);
+  config.screenshotsFolder = screenshotsDir.absolutePath();
+
+  QDir wheelsDir(config.wheelsFolder);
+  checkForFolder(wheelsDir);
+  config.wheelsFolder = wheelsDir.absolutePath();
+
+  QDir marqueesDir(config.marqueesFolder);
+  checkForFolder(marqueesDir);
+  config.marqueesFolder = marqueesDir.absolutePath();
+
+  if(config.videos) {
+    QDir videosDir(config.videosFolder);
+    checkForFolder(videosDir);
+    config.videosFolder = videosDir.absolutePath();
+  }
+
+  QDir importDir(config.importFolder);
+  checkForFolder(importDir, false);
+  config.importFolder = importDir.absolutePath();
+  
+  gameListFileString = gameListDir.absolutePath() + "/" + frontend->getGameListFileName();
+
+  foreach(QSharedPointer<FrontendOutput> output, outputs) {
+    output->config.inputFolder = config.inputFolder;
+    QDir outputGameListDir(output->config.gameListFolder);
+    checkForFolder(outputGameListDir);
+    output->config.gameListFolder = outputGameListDir.absolutePath();
+    QList<QString *> outputFolders({&output->config.coversFolder,
+				    &output->config.screenshotsFolder,
+				    &output->config.wheelsFolder,
+				    &output->config.marqueesFolder});
+    if(config.videos) {
+      outputFolders.append(&output->config.videosFolder);
+    }
+    foreach(QString *outputFolder, outputFolders) {
+      QDir outputDir(*outputFolder);
+      checkForFolder(outputDir);
+      *outputFolder = outputDir.absolutePath();
+    }
+    output->gameListFileString = output->config.gameListFolder + "/" + output->frontend->getGameListFileName();
+  }
+
+  // The daemon serves files one at a time without starting a run, so it needs the
+  // compositors right away
+  if(config.daemon) {
+    createCompositors();
+  }
+
+  return true;
+}
+
+void Skyscraper::startThreads(const QString &scraper)
+{
+  Settings threadConfig = config;
+  threadConfig.scraper = scraper;
+  currentScraper = scraper;
+
+  timer.start();
+  currentFile = 1;
+  doneThreads = 0;
+  runningThreads = 0;
+
+  // Hashing stage. Reads and checksums the files and passes them on to the scraper workers
+  // through a bounded queue, so it never gets too far ahead of them
+  hashThreads = qMax(1, qMin(config.hashThreads, totalFiles));
+  doneHashThreads = 0;
+  hashedQueue = QSharedPointer<BoundedQueue<HashedEntry> >(new BoundedQueue<HashedEntry>(HASHQUEUESIZE));
+  hashedQueue->setProducers(hashThreads);
+  queue->setWorkers(hashThreads);
+
+  // Do not start more threads if we have less files than allowed threads
+  int networkThreads = qMax(1, qMin(config.threads, totalFiles));
+  int cachedThreads = 0;
+  // Files that already have resources from the scraping module don't need the network, so
+  // they get their own threads and are done right away instead of taking up network threads.
+  // This is only relevant for the network modules and when not refreshing the cache
+  cachedQueue.clear();
+  if(scraper != "cache" && scraper != "import" && scraper != "esgamelist" &&
+     !config.refresh && totalFiles > 1) {
+    cachedQueue = QSharedPointer<BoundedQueue<HashedEntry> >(new BoundedQueue<HashedEntry>(HASHQUEUESIZE));
+    cachedQueue->setProducers(hashThreads);
+    cachedThreads = qMin(CACHEDTHREADS, totalFiles);
+  }
+
+  createCompositors();
+
+  QList<QThread*> threadList;
+  for(int curThread = 0; curThread < hashThreads; ++curThread) {
+    QThread *thread = new QThread;
+    HashWorker *worker = new HashWorker(queue, hashedQueue, cachedQueue, cache, threadConfig,
+					curThread);
+    worker->moveToThread(thread);
+    connect(thread, &QThread::started, worker, &HashWorker::run);
+    connect(worker, &HashWorker::allDone, thread, &QThread::quit);
+    connect(worker, &HashWorker::allDone, this, &Skyscraper::hashThreadDone);
+    connect(thread, &QThread::finished, worker, &HashWorker::deleteLater);
+    connect(thread, &QThread::finished, thread, &QThread::deleteLater);
+    threadList.append(thread);
+  }
+
+  generating = (config.singlePass && scraper != "cache");
+
+  // With '-t auto' the governor decides how many of the threads are active at any time
+  governor.clear();
+  if(config.autoThreads && networkThreads > 1) {
+    governor = QSharedPointer<ThreadGovernor>(new ThreadGovernor(networkThreads));
+    governor->start();
+  }
+
+  // Videos are much larger than everything else, so they are downloaded by their own threads
+  // while the scraper threads carry on with the next games
+  videoQueue.clear();
+  if(config.videos && scraper != "cache" && scraper != "import" && scraper != "esgamelist" &&
+     !generating && networkThreads > 1) {
+    videoQueue = QSharedPointer<BoundedQueue<VideoJob> >(new BoundedQueue<VideoJob>(VIDEOQUEUESIZE));
+    videoQueue->setProducers(networkThreads);
+  }
+
+  for(int curThread = 1; curThread <= networkThreads; ++curThread) {
+    threadList.append(createScraperThread(hashedQueue, governor, threadConfig,
+					  QString::number(curThread), false, videoQueue));
+    runningThreads++;
+  }
+  for(int curThread = 1; curThread <= cachedThreads; ++curThread) {
+    threadList.append(createScraperThread(cachedQueue, QSharedPointer<ThreadGovernor>(),
+					  threadConfig, "C" + QString::number(curThread)));
+    runningThreads++;
+  }
+  resourceThreads = runningThreads;
+  doneResourceThreads = 0;
+
+  if(!videoQueue.isNull()) {
+    for(int curThread = 0; curThread < VIDEOTHREADS; ++curThread) {
+      QThread *thread = new QThread;
+      VideoWorker *worker = new VideoWorker(videoQueue, cache, threadConfig);
+      worker->moveToThread(thread);
+      connect(thread, &QThread::started, worker, &VideoWorker::run);
+      connect(worker, &VideoWorker::allDone, this, &Skyscraper::checkThreads);
+      connect(worker, &VideoWorker::allDone, thread, &QThread::quit);
+      connect(thread, &QThread::finished, worker, &VideoWorker::deleteLater);
+      connect(thread, &QThread::finished, thread, &QThread::deleteLater);
+      threadList.append(thread);
+      runningThreads++;
+    }
+  }
+
+  // In single pass mode the game list entries are generated alongside the scraping. Each
+  // scraped file is passed on to these threads, which then work like a 'cache' run
+  if(generating) {
+    generateQueue = QSharedPointer<BoundedQueue<HashedEntry> >(new BoundedQueue<HashedEntry>(qMax(1, totalFiles)));
+    generateQueue->setProducers(1);
+    Settings generateConfig = config;
+    generateConfig.scraper = "cache";
+    if(!config.minMatchSet) {
+      generateConfig.minMatch = 0;
+    }
+    for(int curThread = 1; curThread <= qMin(GENERATETHREADS, totalFiles); ++curThread) {
+      threadList.append(createScraperThread(generateQueue, QSharedPointer<ThreadGovernor>(),
+					    generateConfig, "G" + QString::number(curThread), true));
+      runningThreads++;
+    }
+  }
+
+  // Free disk space is sampled periodically rather than for every finished game
+  if(config.spaceCheck) {
+    spaceTimer.setInterval(SPACECHECKINTERVAL);
+    connect(&spaceTimer, &QTimer::timeout, this, &Skyscraper::checkSpace, Qt::UniqueConnection);
+    spaceTimer.start();
+  }
+  // So is the memory usage. The workers are held back while the budget is exceeded
+  if(config.memCheck) {
+    qint64 budget = (qint64)config.memBudget * 1024 * 1024;
+    if(budget <= 0) {
+      budget = MemoryGuard::getTotalMemory() / 100 * MEMBUDGETPERCENT;
+    }
+    MemoryGuard::setBudget(budget);
+    memTimer.setInterval(MEMCHECKINTERVAL);
+    connect(&memTimer, &QTimer::timeout, this, &Skyscraper::checkMemory, Qt::UniqueConnection);
+    memTimer.start();
+  }
+
+  // Ready, set, GO!!! Start all threads
+  foreach(QThread *thread, threadList) {
+    thread->start();
+    threadsRunning = true;
+  }
+}
+
+void Skyscraper::createCompositors()
+{
+  if(compositor.isNull()) {
+    // The artwork definition is parsed once and the resulting layer tree is shared by all
+    // threads. It is only ever read from while compositing
+    compositor = QSharedPointer<Compositor>(new Compositor(&config));
+    if(!compositor->processXml()) {
+      printf("Something went wrong when parsing artwork xml from '%s', please check the file for errors. Now exiting...\n", config.artworkConfig.toStdString().c_str());
+      exit(1);
+    }
+  }
+  foreach(QSharedPointer<FrontendOutput> output, outputs) {
+    if(output->compositor.isNull()) {
+      output->compositor = QSharedPointer<Compositor>(new Compositor(&output->config));
+      if(!output->compositor->processXml()) {
+	printf("Something went wrong when parsing artwork xml from '%s', please check the file for errors. Now exiting...\n", output->config.artworkConfig.toStdString().c_str());
+	exit(1);
+      }
+    }
+  }
+  // Artwork compositing is CPU bound, so it gets its own pool sized to the number of cores
+  // instead of running inside the scraping threads
+  if(compositorPool.isNull()) {
+    compositorPool = QSharedPointer<QThreadPool>(new QThreadPool);
+    compositorPool->setMaxThreadCount(QThread::idealThreadCount());
+  }
+}
+
+// Scrapes a single file for the daemon. Each request gets its own hash and scraper thread, while
+// the cache, compositors and everything loaded by 'prepare()' stay in memory between requests.
+// If 'composite' is set the artwork is composited into the frontend media folders as when
+// generating a game list. 'done' is called from the event loop once the file is done
+void Skyscraper::serve(const QFileInfo &info, const bool &composite, const bool &refresh,
+		       std::function<void(const GameEntry &entry)> done)
+{
+  QSharedPointer<Queue> requestQueue = QSharedPointer<Queue>(new Queue());
+  requestQueue->append(info);
+  QSharedPointer<BoundedQueue<HashedEntry> > requestHashedQueue = QSharedPointer<BoundedQueue<HashedEntry> >(new BoundedQueue<HashedEntry>(1));
+  requestHashedQueue->setProducers(1);
+
+  Settings threadConfig = config;
+  threadConfig.pretend = !composite;
+  threadConfig.refresh = refresh;
+
+  QThread *hashThread = new QThread;
+  HashWorker *hashWorker = new HashWorker(requestQueue, requestHashedQueue,
+					  QSharedPointer<BoundedQueue<HashedEntry> >(), cache,
+					  threadConfig, 0);
+  hashWorker->moveToThread(hashThread);
+  connect(hashThread, &QThread::started, hashWorker, &HashWorker::run);
+  connect(hashWorker, &HashWorker::allDone, hashThread, &QThread::quit);
+  connect(hashThread, &QThread::finished, hashWorker, &HashWorker::deleteLater);
+  connect(hashThread, &QThread::finished, hashThread, &QThread::deleteLater);
+
+  QThread *thread = new QThread;
+  ScraperWorker *worker = new ScraperWorker(requestQueue, requestHashedQueue, cache, compositor,
+					    compositorPool, QSharedPointer<ThreadGovernor>(),
+					    (composite?outputs:QList<QSharedPointer<FrontendOutput> >()),
+					    threadConfig, "D");
+  worker->moveToThread(thread);
+  connect(thread, &QThread::started, worker, &ScraperWorker::run);
+  connect(worker, &ScraperWorker::entryReady, this,
+	  [this, done](GameEntry entry, ScrapeReport) {
+	    if(config.scraper != "cache" && entry.found) {
+	      cacheWriteTimer.start();
+	    }
+	    done(entry);
+	  });
+  connect(worker, &ScraperWorker::allDone, thread, &QThread::quit);
+  connect(thread, &QThread::finished, worker, &ScraperWorker::deleteLater);
+  connect(thread, &QThread::finished, thread, &QThread::deleteLater);
+
+  hashThread->start();
+  thread->start();
+}
+
+void Skyscraper::flushCache()
+{
+  cacheWriteTimer.stop();
+  if(!cache.isNull()) {
+    cache->write();
+  }
+}
+
+void Skyscraper::stopRun()
+{
+  queue->clearAll();
+  // Also drop the files that have already been checksummed but not yet scraped
+  if(!hashedQueue.isNull()) {
+    hashedQueue->abort();
+  }
+  if(!cachedQueue.isNull()) {
+    cachedQueue->abort();
+  }
+  if(!videoQueue.isNull()) {
+    videoQueue->abort();
+  }
+  if(!governor.isNull()) {
+    governor->finish();
+  }
+}
+
+QThread *Skyscraper::createScraperThread(QSharedPointer<BoundedQueue<HashedEntry> > inputQueue,
+					 QSharedPointer<ThreadGovernor> governor,
+					 const Settings &threadConfig, const QString &threadId,
+					 const bool &generator,
+					 QSharedPointer<BoundedQueue<VideoJob> > videoQueue)
+{
+  QThread *thread = new QThread;
+  ScraperWorker *worker = new ScraperWorker(queue, inputQueue, cache, compositor, compositorPool,
+					    governor, outputs, threadConfig, threadId, videoQueue);
+  worker->moveToThread(thread);
+  connect(thread, &QThread::started, worker, &ScraperWorker::run);
+  connect(worker, &ScraperWorker::outputEntryReady, this, &Skyscraper::outputEntry);
+  connect(worker, &ScraperWorker::promptDone, this, &Skyscraper::printHeldOutput);
+  if(generator) {
+    connect(worker, &ScraperWorker::entryReady, this, &Skyscraper::generatedEntry);
+    connect(worker, &ScraperWorker::allDone, this, &Skyscraper::checkThreads);
+  } else if(generating) {
+    connect(worker, &ScraperWorker::entryReady, this, &Skyscraper::entryReady);
+    connect(worker, &ScraperWorker::allDone, this, &Skyscraper::resourceThreadDone);
+  } else {
+    connect(worker, &ScraperWorker::entryReady, this, &Skyscraper::entryReady);
+    connect(worker, &ScraperWorker::allDone, this, &Skyscraper::checkThreads);
+  }
+  connect(worker, &ScraperWorker::allDone, thread, &QThread::quit);
+  connect(thread, &QThread::finished, worker, &ScraperWorker::deleteLater);
+  connect(thread, &QThread::finished, thread, &QThread::deleteLater);
+  return thread;
+}
+
+void Skyscraper::checkForFolder(QDir &folder, bool create)
+{
+  if(!folder.exists()) {
+    printf("Folder '%s' doesn't exist", folder.absolutePath().toStdString().c_str());
+    if(create) {
+      printf(", trying to create it... ");
+      fflush(stdout);
+      if(folder.mkpath(folder.absolutePath())) {
+	printf("\033[1;32mSuccess!\033[0m\n");
+      } else {
+	printf("\033[1;32mFailed!\033[0m Please check path and permissions, now exiting...\n");
+	exit(1);
+      }
+    } else {
+      printf(", can't continue...\n");
+      exit(1);
+    }
+  }
+}
+
+void Skyscraper::runHashBenchmark(const QList<QFileInfo> &nameOrder)
+{
+  QList<QFileInfo> diskOrder = nameOrder;
+  DiskTools::sortByDiskLocation(diskOrder);
+
+  printf("Benchmarking checksumming of \033[1;32m%d\033[0m files in filename order versus disk location order. Files are evicted from the page cache before each pass to measure actual disk reads.\n\n", nameOrder.length());
+
+  QList<QPair<QString, QList<QFileInfo> > > passes;
+  passes.append(qMakePair(QString("Filename order"), nameOrder));
+  passes.append(qMakePair(QString("Disk order    "), diskOrder));
+  for(int a = 0; a < passes.length(); ++a) {
+    foreach(QFileInfo info, passes.at(a).second) {
+      DiskTools::dropFromPageCache(info);
+    }
+    qint64 bytesRead = 0;
+    QTime benchTimer;
+    benchTimer.start();
+    foreach(QFileInfo info, passes.at(a).second) {
+      QCryptographicHash sha1(QCryptographicHash::Sha1);
+      QFile romFile(info.absoluteFilePath());
+      if(romFile.open(QIODevice::ReadOnly)) {
+	while(!romFile.atEnd()) {
+	  QByteArray dataSeg = romFile.read(65536);
+	  sha1.addData(dataSeg);
+	  bytesRead += dataSeg.length();
+	}
+	romFile.close();
+      }
+    }
+    int elapsed = benchTimer.elapsed();
+    printf("%s: \033[1;33m%d\033[0m ms (%.2f MB/s)\n", passes.at(a).first.toStdString().c_str(),
+	   elapsed, (elapsed > 0?((double)bytesRead / 1048576.0) / ((double)elapsed / 1000.0):0.0));
+  }
+  printf("\n");
+}
+
+QString Skyscraper::secsToString(const int &secs)
+{
+  QString hours = QString::number(secs / 3600000 % 24);
+  QString minutes = QString::number(secs / 60000 % 60);
+  QString seconds = QString::number(secs / 1000 % 60);
+  if(hours.length() == 1) {
+    hours.prepend("0");
+  }
+  if(minutes.length() == 1) {
+    minutes.prepend("0");
+  }
+  if(seconds.length() == 1) {
+    seconds.prepend("0");
+  }
+
+  return hours + ":" + minutes + ":" + seconds;
+}
+
+QString Skyscraper::renderOutput(const GameEntry &entry, const ScrapeReport &report)
+{
+  if(!entry.found) {
+    return report.output + report.limitOutput;
+  }
+  QString output = report.output;
+  output.append("Scraper:        " + currentScraper + "\n");
+  if(currentScraper != "cache" && currentScraper != "import") {
+    output.append("From cache:     " + QString((report.fromCache?"YES (refresh from source with '--cache refresh')":"NO")) + "\n");
+    output.append("Search match:   " + QString::number(entry.searchMatch) + " %\n");
+    output.append("Compare title:  '\033[1;32m" + report.compareTitle + "\033[0m'\n");
+    output.append("Result title:   '\033[1;32m" + report.resultTitle + "\033[0m' (" + entry.titleSrc + ")\n");
+  } else {
+    output.append("Title:          '\033[1;32m" + report.resultTitle + "\033[0m' (" + entry.titleSrc + ")\n");
+  }
+  output.append("Platform:       '\033[1;32m" + entry.platform + "\033[0m' (" + entry.platformSrc + ")\n");
+  output.append("Release Date:   '\033[1;32m");
+  if(entry.releaseDate.isEmpty()) {
+    output.append("\033[0m' ()\n");
+  } else {
+    output.append(QDate::fromString(entry.releaseDate, "yyyyMMdd").toString("yyyy-MM-dd") + "\033[0m' (" + entry.releaseDateSrc + ")\n");
+  }
+  output.append("Developer:      '\033[1;32m" + entry.developer + "\033[0m' (" + entry.developerSrc + ")\n");
+  output.append("Publisher:      '\033[1;32m" + entry.publisher + "\033[0m' (" + entry.publisherSrc + ")\n");
+  output.append("Players:        '\033[1;32m" + entry.players + "\033[0m' (" + entry.playersSrc + ")\n");
+  output.append("Ages:           '\033[1;32m" + entry.ages + (entry.ages.toInt() != 0?"+":"") + "\033[0m' (" + entry.agesSrc + ")\n");
+  output.append("Tags:           '\033[1;32m" + entry.tags + "\033[0m' (" + entry.tagsSrc + ")\n");
+  output.append("Rating (0-1):   '\033[1;32m" + entry.rating + "\033[0m' (" + entry.ratingSrc + ")\n");
+  output.append("Cover:          " + QString((report.cover?"\033[1;32mYES":"\033[1;31mNO")) + "\033[0m" + QString((config.cacheCovers?"":" (uncached)")) + " (" + entry.coverSrc + ")\n");
+  output.append("Screenshot:     " + QString((report.screenshot?"\033[1;32mYES":"\033[1;31mNO")) + "\033[0m" + QString((config.cacheScreenshots?"":" (uncached)")) + " (" + entry.screenshotSrc + ")\n");
+  output.append("Wheel:          " + QString((report.wheel?"\033[1;32mYES":"\033[1;31mNO")) + "\033[0m" + QString((config.cacheWheels?"":" (uncached)")) + " (" + entry.wheelSrc + ")\n");
+  output.append("Marquee:        " + QString((report.marquee?"\033[1;32mYES":"\033[1;31mNO")) + "\033[0m" + QString((config.cacheMarquees?"":" (uncached)")) + " (" + entry.marqueeSrc + ")\n");
+  if(config.videos) {
+    if(report.videoQueued) {
+      output.append("Video:          \033[1;33mQUEUED\033[0m (downloading in the background)\n");
+    } else {
+      output.append("Video:          " + QString((report.video?"\033[1;32mYES":"\033[1;31mNO")) + "\033[0m" + QString((report.videoExceeded?" (size exceeded, uncached)":"")) + " (" + entry.videoSrc + ")\n");
+    }
+  }
+  output.append("\nDescription: (" + entry.descriptionSrc + ")\n'\033[1;32m" + entry.description.left(config.maxLength) + "\033[0m'\n");
+  output.append(report.limitOutput);
+  return output;
+}
+
+void Skyscraper::entryReady(GameEntry entry, ScrapeReport report)
+{
+  QMutexLocker locker(&entryMutex);
+
+  QString console = "\033[0;32m#" + QString::number(currentFile) + "/" + QString::number(totalFiles) + (config.batch?" (" + config.platform + ")":QString()) + "\033[0m " + renderOutput(entry, report) + "\n";
+
+  if(config.verbosity >= 3) {
+    console.append("\033[1;33mDebug output:\033[0m\n" + report.debug + "\n");
+  }
+
+  if(watcher != nullptr) {
+    // When watching, the new entry replaces the existing game list entry for the file
+    for(int a = 0; a < gameEntries.length(); ++a) {
+      if(gameEntries.at(a).path == entry.path) {
+	gameEntries.removeAt(a);
+	break;
+      }
+    }
+  }
+  // Resource gathering rounds in watch mode are followed by a 'cache' round which provides
+  // the actual game list entries, so don't keep the entries from the gathering round
+  bool keepEntry = (watcher == nullptr || currentScraper == "cache");
+  if(generating) {
+    // The resources for this file are in the cache now, so its game list entry can be made
+    HashedEntry hashedEntry;
+    hashedEntry.info = QFileInfo(entry.path);
+    hashedEntry.sha1 = entry.sha1;
+    generateQueue->push(hashedEntry);
+    keepEntry = false;
+  }
+
+  if(checkpointFile.isOpen()) {
+    checkpointFile.write(entry.path.toUtf8() + "\n");
+  }
+
+  if(entry.found) {
+    found++;
+    avgCompleteness += report.completeness;
+    avgSearchMatch += entry.searchMatch;
+    // Media data has already been removed by the worker, so the entry is small at this point
+    if(keepEntry) {
+      gameEntries.append(entry);
+    }
+  } else {
+    notFound++;
+    skippedFile.write("'" + entry.baseName.toUtf8() + "'");
+    if(entry.searchMatch == 0) {
+      skippedFile.write(", No returned matches\n");
+    } else {
+      skippedFile.write(", Closest match was '" + entry.title.toUtf8() + "' at " + QByteArray::number(entry.searchMatch) + "%\n");
+    }
+    if(config.skipped && keepEntry) {
+      gameEntries.append(entry);
+    }
+  }
+  
+  console.append("\033[1;32m" + QString::number(found) + "\033[0m/\033[1;33m" + QString::number(notFound) + "\033[0m/\033[1;34m" + QString::number(currentFile) + "\033[0m\n");
+  int elapsed = timer.elapsed();
+  int estTime = (elapsed / currentFile * totalFiles) - elapsed;
+  if(estTime < 0)
+    estTime = 0;
+  console.append("Elapsed time   : \033[1;33m" + secsToString(elapsed) + "\033[0m\n");
+  console.append("Est. time left : \033[1;33m" + secsToString(estTime) + "\033[0m\n\n");
+  printOutput(console);
+
+  if(currentFile == config.maxFails && notFound == config.maxFails &&
+     config.scraper != "import" && config.scraper != "cache") {
+    if(config.batch) {
+      printf("\033[1;31mOut of %d files we had %d misses. The scraping module probably doesn't support platform '%s', skipping it...\033[0m\n\n", config.maxFails, config.maxFails, config.platform.toStdString().c_str());
+      stopRun();
+    } else {
+      printf("\033[1;31mThis is NOT going well! I guit! *slams the door*\nNo, seriously, out of %d files we had %d misses. So either the scraping source is down or you are using a scraping source that doesn't support this platform. Please try another scraping module (check '--help').\n\nNow exiting...\033[0m\n", config.maxFails, config.maxFails);
+      exit(1);
+    }
+  }
+  currentFile++;
+}
+
+// In interactive mode nothing may be printed while a worker is asking the user to choose an
+// entry. The output is held back until the prompt is done instead of waiting for it here, as
+// that would stall the event loop for as long as the user takes to answer
+void Skyscraper::printOutput(const QString &text)
+{
+  if(config.interactive) {
+    if(!ScraperWorker::promptMutex.tryLock()) {
+      heldOutput.append(text);
+      return;
+    }
+    foreach(QString held, heldOutput) {
+      printf("%s", held.toStdString().c_str());
+    }
+    heldOutput.clear();
+    ScraperWorker::promptMutex.unlock();
+  }
+  printf("%s", text.toStdString().c_str());
+}
+
+void Skyscraper::printHeldOutput()
+{
+  QMutexLocker locker(&entryMutex);
+  if(!heldOutput.isEmpty()) {
+    printOutput(QString());
+  }
+}
+
+// Keeps only the files belonging to this shard. Files are assigned by a hash of their path
+// relative to the input folder, so every machine assigns them the same way no matter where the
+// roms are mounted, and adding files doesn't move the existing ones to another shard
+void Skyscraper::applyShard(QList<QFileInfo> &infoList)
+{
+  QDir inputDir(config.inputFolder);
+  QList<QFileInfo> shardList;
+  foreach(QFileInfo info, infoList) {
+    QByteArray hash = QCryptographicHash::hash(inputDir.relativeFilePath(info.absoluteFilePath()).toUtf8(), QCryptographicHash::Sha1);
+    quint32 value = ((quint8)hash.at(0) << 24) | ((quint8)hash.at(1) << 16) |
+      ((quint8)hash.at(2) << 8) | (quint8)hash.at(3);
+    if((int)(value % config.shardCount) == config.shardIndex - 1) {
+      shardList.append(info);
+    }
+  }
+  printf("Shard \033[1;32m%d\033[0m of \033[1;32m%d\033[0m has \033[1;32m%d\033[0m of the \033[1;32m%d\033[0m files.\n", config.shardIndex, config.shardCount, shardList.length(), infoList.length());
+  infoList = shardList;
+}
+
+// Each processed file is added to the checkpoint file. When resuming, the files that are
+// already in it are removed from 'infoList' and new ones are appended to it
+void Skyscraper::openCheckpoint(QList<QFileInfo> &infoList)
+{
+  checkpointFile.setFileName(checkpointFileString);
+  if(config.resume) {
+    if(checkpointFile.open(QIODevice::ReadOnly)) {
+      QSet<QString> processed;
+      while(!checkpointFile.atEnd()) {
+	QString path = QString::fromUtf8(checkpointFile.readLine());
+	path.chop(1);
+	processed.insert(path);
+      }
+      checkpointFile.close();
+      QList<QFileInfo> remaining;
+      foreach(QFileInfo info, infoList) {
+	if(!processed.contains(info.absoluteFilePath())) {
+	  remaining.append(info);
+	}
+      }
+      printf("Resuming from checkpoint, skipping \033[1;32m%d\033[0m already processed files.\n", infoList.length() - remaining.length());
+      infoList = remaining;
+    } else {
+      printf("\033[1;33mNo checkpoint found for this platform and module, starting from the beginning.\033[0m\n");
+    }
+  }
+  if(!checkpointFile.open(config.resume?QIODevice::Append:QIODevice::WriteOnly)) {
+    printf("\033[1;31mCouldn't open checkpoint file '%s' for writing, please check permissions. Now exiting...\033[0m\n", checkpointFileString.toStdString().c_str());
+    exit(1);
+  }
+}
+
+void Skyscraper::budgetReached()
+{
+  if(!threadsRunning) {
+    return;
+  }
+  printf("\033[1;33mTime budget of %d minutes reached. Finishing the games in progress and stopping...\033[0m\n\n", config.timeBudget);
+  watchMode = false;
+  stopRun();
+}
+
+// Receives the game list entries from the generation threads in single pass mode. The scraping
+// output for the games has already been printed by 'entryReady'
+void Skyscraper::generatedEntry(GameEntry entry, ScrapeReport report)
+{
+  QMutexLocker locker(&entryMutex);
+
+  if(config.verbosity >= 3) {
+    printf("\033[1;33mGame list entry debug output:\033[0m\n%s\n", report.debug.toStdString().c_str());
+  }
+  if(watcher != nullptr) {
+    for(int a = 0; a < gameEntries.length(); ++a) {
+      if(gameEntries.at(a).path == entry.path) {
+	gameEntries.removeAt(a);
+	break;
+      }
+    }
+  }
+  if(entry.found || config.skipped) {
+    gameEntries.append(entry);
+  }
+}
+
+// Receives the game list entries for the additional frontends. Old entries for the same file
+// are removed when the game lists are written
+void Skyscraper::outputEntry(int output, GameEntry entry)
+{
+  QMutexLocker locker(&entryMutex);
+
+  if(entry.found || config.skipped) {
+    outputs.at(output)->gameEntries.append(entry);
+  }
+}
+
+// Once all files have been checksummed only the games already in progress are left. In batch
+// mode the next platform is started at this point, so the network is kept busy
+void Skyscraper::hashThreadDone()
+{
+  doneHashThreads++;
+  if(doneHashThreads == hashThreads) {
+    emit hashingDone();
+  }
+}
+
+void Skyscraper::resourceThreadDone()
+{
+  doneResourceThreads++;
+  // All resource entries have been received at this point, since they are emitted before
+  // 'allDone' from the same thread
+  if(doneResourceThreads == resourceThreads) {
+    generateQueue->producerDone();
+  }
+  checkThreads();
+}
+
+void Skyscraper::checkSpace()
+{
+#if QT_VERSION >= 0x050400
+  qint64 spaceLimit = 209715200;
+  if(QStorageInfo(QDir(config.mediaFolder)).bytesFree() < spaceLimit ||
+     QStorageInfo(QDir::current()).bytesFree() < spaceLimit) {
+    printf("\033[1;31mYou have very little disk space left either on the Skyscraper resource cache drive or on the game list and media export drive, please free up some space and try again. Now aborting...\033[0m\n\nNote! You can disable this check by setting 'spaceCheck=\"false\"' in the '[main]' section of config.ini.\n\n");
     // Clean up and exit
-    if(config.scraper == "cache") {
+    if(config.scraper == "cache" || generating) {
       config.pretend = true;
     }
     // By clearing the queue here we basically tell Skyscraper to stop and quit nicely
-    queue->clearAll();
+    watchMode = false;
+    spaceTimer.stop();
+    stopRun();
   }
 #endif
 }
 
+void Skyscraper::checkMemory()
+{
+  qint64 available = MemoryGuard::getAvailableMemory();
+  if(available >= 0 && available < MEMAVAILABLELIMIT) {
+    printf("\033[1;31mYou have very little memory left, please close some other programs or lower 'memBudget' and try again. Now aborting...\033[0m\n\nNote! You can disable this check by setting 'memCheck=\"false\"' in the '[main]' section of config.ini.\n\n");
+    // Clean up and exit. The cache is still written
+    if(config.scraper == "cache" || generating) {
+      config.pretend = true;
+    }
+    watchMode = false;
+    memTimer.stop();
+    stopRun();
+    return;
+  }
+
+  MemoryGuard::update();
+  // The finished entries aren't needed until the game list is written, so move them to disk
+  // when getting close to the budget. Watch mode looks them up for every change, so it keeps them
+  if(!MemoryGuard::isNearBudget() || watcher != nullptr) {
+    return;
+  }
+  QMutexLocker locker(&entryMutex);
+  if(gameEntries.length() >= SPILLMINENTRIES) {
+    entrySpill.spill(gameEntries);
+  }
+  foreach(QSharedPointer<FrontendOutput> output, outputs) {
+    if(output->gameEntries.length() >= SPILLMINENTRIES) {
+      output->entrySpill.spill(output->gameEntries);
+    }
+  }
+}
+
 void Skyscraper::checkThreads()
 {
   QMutexLocker locker(&checkThreadMutex);
 
   doneThreads++;
-  if(doneThreads != config.threads)
+  if(doneThreads != runningThreads)
     return;
 
-  if(!config.pretend && config.scraper == "cache") {
-    printf("\033[1;34m---- Game list generation run completed! YAY! ----\033[0m\n");
-    QString finalOutput;
-    frontend->sortEntries(gameEntries);
-    printf("Assembling game list...");
-    frontend->assembleList(finalOutput, gameEntries);
-    printf(" \033[1;32mDone!!!\033[0m\n");
-    QFile gameListFile(gameListFileString);
-    printf("Now writing '%s'... ", gameListFileString.toStdString().c_str());
-    fflush(stdout);
-    if(gameListFile.open(QIODevice::WriteOnly)) {
-      gameListFile.write(finalOutput.toUtf8());
-      gameListFile.close();
-      printf("\033[1;32mSuccess!!!\033[0m\n\n");
-    } else {
-      printf("\033[1;31mCouldn't open file for writing!!!\nAll that work for nothing... :(\033[0m\n");
-    }
-  } else {
+  // The workers are done, so there are no prompts left to wait for
+  printHeldOutput();
+  threadsRunning = false;
+  spaceTimer.stop();
+  memTimer.stop();
+  budgetTimer.stop();
+  skippedFile.flush();
+  // If the scraper workers stopped early (such as when reaching a module limit) there might
+  // still be hash workers waiting for room in the queue. This releases them
+  stopRun();
+
+  if(currentScraper != "cache") {
     printf("\033[1;34m---- Resource gathering run completed! YAY! ----\033[0m\n");
     if(!config.cacheFolder.isEmpty()) {
       cache->write();
     }
   }
+  if(!config.pretend && (currentScraper == "cache" || generating)) {
+    printf("\033[1;34m---- Game list generation run completed! YAY! ----\033[0m\n");
+    writeGameList();
+  }
   
   printf("\033[1;34m---- And here are some neat stats :) ----\033[0m\n");
-  printf("Total completion time: \033[1;33m%s\033[0m\n\n", secsToString(timer.elapsed()).toStdString().c_str());
+  printf("Total completion time: \033[1;33m%s\033[0m\n", secsToString(timer.elapsed()).toStdString().c_str());
+  if(MemoryGuard::getPeakRss() > 0) {
+    printf("Peak memory usage: \033[1;33m%lld MB\033[0m", MemoryGuard::getPeakRss() / 1024 / 1024);
+    if(MemoryGuard::getBudget() > 0) {
+      printf(" (budget %lld MB)", MemoryGuard::getBudget() / 1024 / 1024);
+    }
+    printf("\n");
+  }
+  printf("\n");
   if(found > 0) {
     printf("Average search match: \033[1;33m%d%%\033[0m\n",
 	   (int)((double)avgSearchMatch / (double)found));
@@ -514,141 +1201,254 @@ void Skyscraper::checkThreads()
   printf("\033[1;32mSuccessfully processed games: %d\033[0m\n", found);
   printf("\033[1;33mSkipped games: %d (Filenames saved to '~/.skyscraper/%s')\033[0m\n\n", notFound, skippedFileString.toStdString().c_str());
 
+  if(checkpointFile.isOpen()) {
+    checkpointFile.close();
+    if(currentFile > totalFiles) {
+      // Everything was processed, so there's nothing to resume
+      checkpointFile.remove();
+    } else {
+      printf("\033[1;33mStopped before all files were processed. Continue the run with '--resume'.\033[0m\n\n");
+    }
+  }
+
+  if(watchMode) {
+    if(watcher == nullptr) {
+      startWatching();
+    } else if(currentScraper != "cache" && !config.pretend && !generating) {
+      // Resources for the new files are now in the cache, generate their game list entries
+      startRound("cache");
+    }
+    return;
+  }
+
   // All done, now clean up and exit to terminal
   emit finished();
 }
 
-void Skyscraper::loadConfig(const QCommandLineParser &parser)
+void Skyscraper::writeGameList()
 {
-  QString current;
-  QString distro;
-
-  /* -----
-     Files that should ALWAYS be updated from distributed default files
-     ----- */
-
-  current = "config.ini.example";
-  distro = "/usr/local/etc/skyscraper/config.ini.example";
-  copyFile(distro, current);
-
-  current = "README.md";
-  distro = "/usr/local/etc/skyscraper/README.md";
-  copyFile(distro, current);
-
-  current = "hints.txt";
-  distro = "/usr/local/etc/skyscraper/hints.txt";
-  copyFile(distro, current);
-
-  current = "ARTWORK.md";
-  distro = "/usr/local/etc/skyscraper/ARTWORK.md";
-  copyFile(distro, current);
-
-  current = "artwork.xml.example1";
-  distro = "/usr/local/etc/skyscraper/artwork.xml.example1";
-  copyFile(distro, current);
-
-  current = "artwork.xml.example2";
-  distro = "/usr/local/etc/skyscraper/artwork.xml.example2";
-  copyFile(distro, current);
-
-  current = "artwork.xml.example3";
-  distro = "/usr/local/etc/skyscraper/artwork.xml.example3";
-  copyFile(distro, current);
-
-  current = "artwork.xml.example4";
-  distro = "/usr/local/etc/skyscraper/artwork.xml.example4";
-  copyFile(distro, current);
-
-  current = "mameMap.csv";
-  distro = "/usr/local/etc/skyscraper/mameMap.csv";
-  copyFile(distro, current);
-  
-  current = "tgdb_developers.json";
-  distro = "/usr/local/etc/skyscraper/tgdb_developers.json";
-  copyFile(distro, current);
-
-  current = "tgdb_publishers.json";
-  distro = "/usr/local/etc/skyscraper/tgdb_publishers.json";
-  copyFile(distro, current);
-
-  current = "resources/boxfront.png";
-  distro = "/usr/local/etc/skyscraper/resources/boxfront.png";
-  copyFile(distro, current);
-
-  current = "resources/boxside.png";
-  distro = "/usr/local/etc/skyscraper/resources/boxside.png";
-  copyFile(distro, current);
+  // Workers are done at this point, so there's room for the entries that were moved to disk
+  entrySpill.restore(gameEntries);
+  writeGameList(frontend, gameEntries, gameListFileString);
+  foreach(QSharedPointer<FrontendOutput> output, outputs) {
+    output->entrySpill.restore(output->gameEntries);
+    // Only keep the newest entry for each file, old entries might have been regenerated
+    QSet<QString> paths;
+    for(int a = output->gameEntries.length() - 1; a >= 0; --a) {
+      if(paths.contains(output->gameEntries.at(a).path)) {
+	output->gameEntries.removeAt(a);
+      } else {
+	paths.insert(output->gameEntries.at(a).path);
+      }
+    }
+    writeGameList(output->frontend, output->gameEntries, output->gameListFileString);
+  }
+}
 
-  current = "cache/README.md";
-  distro = "/usr/local/etc/skyscraper/docs/CACHE.md";
-  copyFile(distro, current);
+void Skyscraper::writeGameList(AbstractFrontend *listFrontend, QList<GameEntry> &entries,
+			       const QString &fileString)
+{
+  QString finalOutput;
+  listFrontend->sortEntries(entries);
+  printf("Assembling game list...");
+  listFrontend->assembleList(finalOutput, entries);
+  printf(" \033[1;32mDone!!!\033[0m\n");
+  QFile gameListFile(fileString);
+  printf("Now writing '%s'... ", fileString.toStdString().c_str());
+  fflush(stdout);
+  if(gameListFile.open(QIODevice::WriteOnly)) {
+    gameListFile.write(finalOutput.toUtf8());
+    gameListFile.close();
+    printf("\033[1;32mSuccess!!!\033[0m\n\n");
+  } else {
+    printf("\033[1;31mCouldn't open file for writing!!!\nAll that work for nothing... :(\033[0m\n");
+  }
+}
 
-  current = "cache/priorities.xml.example";
-  distro = "/usr/local/etc/skyscraper/cache/priorities.xml.example";
-  copyFile(distro, current);
+void Skyscraper::startWatching()
+{
+  // Use the game list as it is on disk as the base for all following incremental updates
+  gameEntries.clear();
+  if(QFileInfo::exists(gameListFileString) &&
+     frontend->canSkip() && frontend->loadOldGameList(gameListFileString)) {
+    QList<QFileInfo> emptyQueue;
+    frontend->skipExisting(gameEntries, emptyQueue);
+    printf("\n");
+  }
+  foreach(QSharedPointer<FrontendOutput> output, outputs) {
+    output->gameEntries.clear();
+    if(QFileInfo::exists(output->gameListFileString) && output->frontend->canSkip() &&
+       output->frontend->loadOldGameList(output->gameListFileString)) {
+      QList<QFileInfo> emptyQueue;
+      output->frontend->skipExisting(output->gameEntries, emptyQueue);
+    }
+  }
 
-  current = "import/README.md";
-  distro = "/usr/local/etc/skyscraper/import/IMPORT.md";
-  copyFile(distro, current);
+  watchedFiles = scanInputFolder();
+  watcher = new QFileSystemWatcher(this);
+  connect(watcher, &QFileSystemWatcher::directoryChanged, this, &Skyscraper::inputChanged);
+  updateWatchedDirs();
 
-  current = "import/definitions.dat.example1";
-  distro = "/usr/local/etc/skyscraper/import/definitions.dat.example1";
-  copyFile(distro, current);
+  // Files are often added in bulk or copied slowly over the network, so wait until things
+  // have settled before checking what has changed
+  watchTimer.setSingleShot(true);
+  watchTimer.setInterval(WATCHDELAY);
+  connect(&watchTimer, &QTimer::timeout, this, &Skyscraper::checkWatched);
 
-  current = "import/definitions.dat.example2";
-  distro = "/usr/local/etc/skyscraper/import/definitions.dat.example2";
-  copyFile(distro, current);
+  printf("\033[1;34m---- Now watching '%s' for new or changed files, press Ctrl+C to quit ----\033[0m\n\n", config.inputFolder.toStdString().c_str());
+}
 
-  /* -----
-    Files that will only be overwritten if they don't already exist
-    ----- */
+void Skyscraper::updateWatchedDirs()
+{
+  QStringList dirs;
+  dirs.append(config.inputFolder);
+  if(config.subdirs) {
+    QDirIterator dirIt(config.inputFolder,
+		       QDir::Dirs | QDir::NoDotAndDotDot | QDir::NoSymLinks,
+		       QDirIterator::Subdirectories);
+    while(dirIt.hasNext()) {
+      dirs.append(dirIt.next());
+    }
+  }
+  foreach(QString dir, dirs) {
+    if(!watcher->directories().contains(dir)) {
+      watcher->addPath(dir);
+    }
+  }
+}
 
-  current = "artwork.xml";
-  distro = "/usr/local/etc/skyscraper/artwork.xml";
-  copyFile(distro, current, false); // False means it won't overwrite if it exists
+QMap<QString, QFileInfo> Skyscraper::scanInputFolder()
+{
+  QMap<QString, QFileInfo> files;
+  QDir inputDir(config.inputFolder, Platform::getFormats(config.platform, config.extensions, config.addExtensions), QDir::Name, QDir::Files);
+  foreach(QFileInfo info, inputDir.entryInfoList()) {
+    files[info.absoluteFilePath()] = info;
+  }
+  if(config.subdirs) {
+    QDirIterator dirIt(config.inputFolder,
+		       QDir::Dirs | QDir::NoDotAndDotDot | QDir::NoSymLinks,
+		       QDirIterator::Subdirectories);
+    while(dirIt.hasNext()) {
+      inputDir.setPath(dirIt.next());
+      foreach(QFileInfo info, inputDir.entryInfoList()) {
+	files[info.absoluteFilePath()] = info;
+      }
+    }
+  }
+  return files;
+}
 
-  current = "aliasMap.csv";
-  distro = "/usr/local/etc/skyscraper/aliasMap.csv";
-  copyFile(distro, current, false);
+void Skyscraper::inputChanged(const QString &)
+{
+  // Restarts the timer, so we only check once things have calmed down
+  watchTimer.start();
+}
 
-  current = "resources/maskexample.png";
-  distro = "/usr/local/etc/skyscraper/resources/maskexample.png";
-  copyFile(distro, current, false);
+void Skyscraper::checkWatched()
+{
+  if(threadsRunning) {
+    // Wait for the current round to finish before starting a new one
+    watchTimer.start();
+    return;
+  }
 
-  current = "resources/frameexample.png";
-  distro = "/usr/local/etc/skyscraper/resources/frameexample.png";
-  copyFile(distro, current, false);
+  updateWatchedDirs();
+  QMap<QString, QFileInfo> currentFiles = scanInputFolder();
 
-  current = "resources/scanlines1.png";
-  distro = "/usr/local/etc/skyscraper/resources/scanlines1.png";
-  copyFile(distro, current, false);
+  QList<QFileInfo> changedFiles;
+  foreach(QFileInfo info, currentFiles) {
+    qint64 age = info.lastModified().msecsTo(QDateTime::currentDateTime());
+    if(age >= 0 && age < WATCHDELAY) {
+      // File is probably still being written, check everything again a bit later
+      watchTimer.start();
+      return;
+    }
+    if(!watchedFiles.contains(info.absoluteFilePath()) ||
+       watchedFiles.value(info.absoluteFilePath()).size() != info.size() ||
+       watchedFiles.value(info.absoluteFilePath()).lastModified() != info.lastModified()) {
+      changedFiles.append(info);
+    }
+  }
 
-  current = "resources/scanlines2.png";
-  distro = "/usr/local/etc/skyscraper/resources/scanlines2.png";
-  copyFile(distro, current, false);
+  int removedFiles = 0;
+  foreach(QString filePath, watchedFiles.keys()) {
+    if(!currentFiles.contains(filePath)) {
+      for(int a = 0; a < gameEntries.length(); ++a) {
+	if(gameEntries.at(a).path == filePath) {
+	  gameEntries.removeAt(a);
+	  removedFiles++;
+	  break;
+	}
+      }
+      foreach(QSharedPointer<FrontendOutput> output, outputs) {
+	for(int a = output->gameEntries.length() - 1; a >= 0; --a) {
+	  if(output->gameEntries.at(a).path == filePath) {
+	    output->gameEntries.removeAt(a);
+	  }
+	}
+      }
+    }
+  }
+  watchedFiles = currentFiles;
 
-  // Copy one of the example definitions.dat files if none exists
-  current = "import/definitions.dat";
-  distro = "/usr/local/etc/skyscraper/import/definitions.dat.example2";
-  copyFile(distro, current, false);
+  if(!changedFiles.isEmpty()) {
+    printf("Found \033[1;32m%d\033[0m new or changed files.\n\n", changedFiles.length());
+    watchFiles = changedFiles;
+    startRound(config.scraper);
+  } else if(removedFiles > 0 && !config.pretend) {
+    printf("Removed \033[1;33m%d\033[0m entries for files that no longer exist.\n", removedFiles);
+    writeGameList();
+  }
+}
 
-  /* -----
-     END updating files from distribution files
-    ----- */
+void Skyscraper::startRound(const QString &scraper)
+{
+  queue = QSharedPointer<Queue>(new Queue());
+  queue->append(watchFiles);
+  totalFiles = queue->length();
+  notFound = 0;
+  found = 0;
+  avgCompleteness = 0;
+  avgSearchMatch = 0;
+  startThreads(scraper);
+}
 
-  migrate(parser.isSet("c")?parser.value("c"):"config.ini");
+void Skyscraper::loadConfig(const QCommandLineParser &parser, const QString &platform,
+			    const QString &scraper)
+{
+  // The distribution files only need to be checked once, even when running several platforms
+  if(!filesUpdated) {
+    updateFiles();
+    migrate(parser.isSet("c")?parser.value("c"):"config.ini");
+    filesUpdated = true;
+  }
 
   QSettings settings(parser.isSet("c")?parser.value("c"):"config.ini", QSettings::IniFormat);
 
   // Start by setting frontend, since we need it to set default for gamelist and so on
+  QString frontends = config.frontend;
   settings.beginGroup("main");
   if(settings.contains("frontend")) {
-    config.frontend = settings.value("frontend").toString();
+    frontends = settings.value("frontend").toString();
   }
   settings.endGroup();
-  if(parser.isSet("f") && (parser.value("f") == "emulationstation" ||
-			   parser.value("f") == "attractmode")) {
-    config.frontend = parser.value("f");
+  if(parser.isSet("f")) {
+    frontends = parser.value("f");
+  }
+  // Several frontends can be given as a comma separated list. The first one is the main
+  // frontend that all other options apply to, the rest are generated alongside it
+  QList<QString> frontendList;
+  foreach(QString frontendName, frontends.split(",", QString::SkipEmptyParts)) {
+    frontendName = frontendName.simplified();
+    if(frontendName != "emulationstation" && frontendName != "attractmode") {
+      printf("\033[1;33mUnknown frontend '%s', ignoring...\033[0m\n", frontendName.toStdString().c_str());
+    } else if(!frontendList.contains(frontendName)) {
+      frontendList.append(frontendName);
+    }
+  }
+  if(!frontendList.isEmpty()) {
+    config.frontend = frontendList.takeFirst();
+    config.extraFrontends = frontendList;
   }
   if(config.frontend == "emulationstation") {
     frontend = new EmulationStation;
@@ -685,6 +1485,9 @@ void Skyscraper::loadConfig(const QCommandLineParser &parser)
   if(settings.contains("unpack")) {
     config.unpack = settings.value("unpack").toBool();
   }
+  if(settings.contains("crcOnly")) {
+    config.crcOnly = settings.value("crcOnly").toBool();
+  }
   if(settings.contains("interactive")) {
     config.interactive = settings.value("interactive").toBool();
   }
@@ -706,12 +1509,20 @@ void Skyscraper::loadConfig(const QCommandLineParser &parser)
   if(settings.contains("subdirs")) {
     config.subdirs = settings.value("subdirs").toBool();
   }
+  if(settings.contains("diskOrder")) {
+    config.diskOrder = settings.value("diskOrder").toBool();
+  }
+  if(settings.contains("singlePass")) {
+    config.singlePass = settings.value("singlePass").toBool();
+  }
+  if(settings.contains("hashThreads")) {
+    config.hashThreads = settings.value("hashThreads").toInt();
+  }
   if(settings.contains("maxLength")) {
     config.maxLength = settings.value("maxLength").toInt();
   }
   if(settings.contains("threads")) {
-    config.threads = settings.value("threads").toInt();
-    config.threadsSet = true;
+    setThreads(settings.value("threads").toString());
   }
   if(settings.contains("emulator")) {
     config.emulator = settings.value("emulator").toString();
@@ -722,6 +1533,9 @@ void Skyscraper::loadConfig(const QCommandLineParser &parser)
   if(settings.contains("videoSizeLimit")) {
     config.videoSizeLimit = settings.value("videoSizeLimit").toInt() * 1000 * 1000;
   }
+  if(settings.contains("videoBandwidth")) {
+    config.videoBandwidth = settings.value("videoBandwidth").toInt();
+  }
   if(settings.contains("symlink")) {
     config.symlink = settings.value("symlink").toBool();
   }
@@ -765,7 +1579,10 @@ void Skyscraper::loadConfig(const QCommandLineParser &parser)
     config.cacheMarquees = settings.value("cacheMarquees").toBool();
   }
   // Check for command line platform here, since we need it for 'platform' config.ini entries
-  if(parser.isSet("p") && Platform::getPlatforms().contains(parser.value("p"))) {
+  if(!platform.isEmpty()) {
+    config.platform = platform;
+    config.batch = true;
+  } else if(parser.isSet("p") && Platform::getPlatforms().contains(parser.value("p"))) {
     config.platform = parser.value("p");
   } else {
     printf("Please set a valid platform with '-p [platform]'\nCheck '--help' for a list of supported platforms, now exiting...\n");
@@ -796,6 +1613,12 @@ void Skyscraper::loadConfig(const QCommandLineParser &parser)
   if(settings.contains("spaceCheck")) {
     config.spaceCheck = settings.value("spaceCheck").toBool();
   }
+  if(settings.contains("memCheck")) {
+    config.memCheck = settings.value("memCheck").toBool();
+  }
+  if(settings.contains("memBudget")) {
+    config.memBudget = settings.value("memBudget").toInt();
+  }
   settings.endGroup();
 
   // Platform specific configs, overrides main and defaults
@@ -845,6 +1668,15 @@ void Skyscraper::loadConfig(const QCommandLineParser &parser)
   if(settings.contains("subdirs")) {
     config.subdirs = settings.value("subdirs").toBool();
   }
+  if(settings.contains("diskOrder")) {
+    config.diskOrder = settings.value("diskOrder").toBool();
+  }
+  if(settings.contains("singlePass")) {
+    config.singlePass = settings.value("singlePass").toBool();
+  }
+  if(settings.contains("hashThreads")) {
+    config.hashThreads = settings.value("hashThreads").toInt();
+  }
   if(settings.contains("relativePaths")) {
     config.relativePaths = settings.value("relativePaths").toBool();
   }
@@ -871,8 +1703,7 @@ void Skyscraper::loadConfig(const QCommandLineParser &parser)
     config.regionPriosStr = settings.value("regionPrios").toString();
   }
   if(settings.contains("threads")) {
-    config.threads = settings.value("threads").toInt();
-    config.threadsSet = true;
+    setThreads(settings.value("threads").toString());
   }
   if(settings.contains("videos")) {
     config.videos = settings.value("videos").toBool();
@@ -880,6 +1711,9 @@ void Skyscraper::loadConfig(const QCommandLineParser &parser)
   if(settings.contains("videoSizeLimit")) {
     config.videoSizeLimit = settings.value("videoSizeLimit").toInt() * 1000 * 1000;
   }
+  if(settings.contains("videoBandwidth")) {
+    config.videoBandwidth = settings.value("videoBandwidth").toInt();
+  }
   if(settings.contains("symlink")) {
     config.symlink = settings.value("symlink").toBool();
   }
@@ -895,6 +1729,9 @@ void Skyscraper::loadConfig(const QCommandLineParser &parser)
   if(settings.contains("unpack")) {
     config.unpack = settings.value("unpack").toBool();
   }
+  if(settings.contains("crcOnly")) {
+    config.crcOnly = settings.value("crcOnly").toBool();
+  }
   if(settings.contains("unattend")) {
     config.unattend = settings.value("unattend").toBool();
   }
@@ -931,6 +1768,10 @@ void Skyscraper::loadConfig(const QCommandLineParser &parser)
 			   parser.value("s") == "import")) {
     config.scraper = parser.value("s");
   }
+  // The daemon decides the module for each of its platforms itself
+  if(!scraper.isEmpty()) {
+    config.scraper = scraper;
+  }
 
   // Scraping module specific configs, overrides main, platform and defaults
   settings.beginGroup(config.scraper);
@@ -938,8 +1779,7 @@ void Skyscraper::loadConfig(const QCommandLineParser &parser)
     config.userCreds = settings.value("userCreds").toString();
   }
   if(settings.contains("threads")) {
-    config.threads = settings.value("threads").toInt();
-    config.threadsSet = true;
+    setThreads(settings.value("threads").toString());
   }
   if(settings.contains("minMatch")) {
     config.minMatch = settings.value("minMatch").toInt();
@@ -969,15 +1809,23 @@ void Skyscraper::loadConfig(const QCommandLineParser &parser)
   if(settings.contains("videoSizeLimit")) {
     config.videoSizeLimit = settings.value("videoSizeLimit").toInt() * 1000 * 1000;
   }
+  if(settings.contains("videoBandwidth")) {
+    config.videoBandwidth = settings.value("videoBandwidth").toInt();
+  }
+  if(settings.contains("rateLimit")) {
+    config.rateLimit = settings.value("rateLimit").toDouble();
+  }
+  if(settings.contains("rateBurst")) {
+    config.rateBurst = settings.value("rateBurst").toInt();
+  }
   settings.endGroup();
 
   // Command line configs, overrides main, platform, module and defaults
   if(parser.isSet("l") && parser.value("l").toInt() >= 0 && parser.value("l").toInt() <= 10000) {
     config.maxLength = parser.value("l").toInt();
   }
-  if(parser.isSet("t") && parser.value("t").toInt() <= 8) {
-    config.threads = parser.value("t").toInt();
-    config.threadsSet = true;
+  if(parser.isSet("t") && (parser.value("t") == "auto" || parser.value("t").toInt() <= 8)) {
+    setThreads(parser.value("t"));
   }
   if(parser.isSet("e")) {
     config.emulator = parser.value("e");
@@ -1054,9 +1902,40 @@ void Skyscraper::loadConfig(const QCommandLineParser &parser)
   if(parser.isSet("nosubdirs")) {
     config.subdirs = false;
   }
+  if(parser.isSet("diskorder")) {
+    config.diskOrder = true;
+  }
+  if(parser.isSet("watch")) {
+    config.watch = true;
+  }
+  if(parser.isSet("singlepass")) {
+    config.singlePass = true;
+  }
+  if(parser.isSet("timebudget") && parser.value("timebudget").toInt() > 0) {
+    config.timeBudget = parser.value("timebudget").toInt();
+  }
+  if(parser.isSet("resume")) {
+    config.resume = true;
+  }
+  if(parser.isSet("shard")) {
+    QList<QString> shard = parser.value("shard").split("/");
+    if(shard.length() != 2 || shard.at(0).toInt() < 1 ||
+       shard.at(0).toInt() > shard.at(1).toInt()) {
+      printf("Please set '--shard' as 'INDEX/COUNT', such as '1/4', now exiting...\n");
+      exit(1);
+    }
+    config.shardIndex = shard.at(0).toInt();
+    config.shardCount = shard.at(1).toInt();
+  }
+  if(parser.isSet("hashbench")) {
+    config.hashBench = true;
+  }
   if(parser.isSet("unpack")) {
     config.unpack = true;
   }
+  if(parser.isSet("crconly")) {
+    config.crcOnly = true;
+  }
   if(parser.isSet("startat")) {
     config.startAt = parser.value("startat");
   }
@@ -1135,7 +2014,31 @@ void Skyscraper::loadConfig(const QCommandLineParser &parser)
     config.minMatch = 0;
   }
 
-  skippedFileString = "skipped-" + config.scraper + ".txt";
+  // Overlapping platforms in batch mode can't share the file
+  skippedFileString = "skipped-" + (config.batch?config.platform + "-":QString()) + config.scraper + ".txt";
+  checkpointFileString = "checkpoint-" + config.platform + "-" + config.scraper + (config.shardCount > 0?"-shard" + QString::number(config.shardIndex) + "of" + QString::number(config.shardCount):QString()) + ".txt";
+  // A shard only has some of the files, so it can't be used to generate a complete game list
+  if(config.shardCount > 0 && config.scraper == "cache") {
+    printf("\033[1;33m'--shard' is only used when scraping with a module, ignoring...\033[0m\n\n");
+    config.shardIndex = 0;
+    config.shardCount = 0;
+  } else if(config.shardCount > 0 && (config.singlePass || config.watch)) {
+    printf("\033[1;33m'--singlepass' and '--watch' generate a game list, which can't be done from a shard since it only has some of the files, ignoring...\033[0m\n\n");
+    config.singlePass = false;
+    config.watch = false;
+  }
+  // Game list generation always needs every file, so checkpoints only make sense when scraping
+  if(config.scraper == "cache" && (config.timeBudget > 0 || config.resume)) {
+    printf("\033[1;33m'--timebudget' and '--resume' are only used when scraping with a module, ignoring...\033[0m\n\n");
+    config.timeBudget = 0;
+    config.resume = false;
+  }
+  // A resumed run skips the files that are already done and a time budget might stop the run
+  // early, so the game list written by a single pass run would be missing games
+  if(config.singlePass && (config.timeBudget > 0 || config.resume)) {
+    printf("\033[1;33m'--singlepass' only writes the files processed in this run to the game list, which can't be done with '--timebudget' or '--resume' since they only process some of the files, ignoring...\033[0m\n\n");
+    config.singlePass = false;
+  }
 
   // If user has set specific files to scrape on command line set them internally
   foreach(QString cliArgument, parser.positionalArguments()) {
@@ -1175,7 +2078,7 @@ void Skyscraper::loadConfig(const QCommandLineParser &parser)
     config.subdirs = false;
   }
   
-  // If interactive is set, force 1 thread and always accept the chosen result
+  // If interactive is set, limit the threads and always accept the chosen result
   if(config.interactive) {
     if(config.scraper == "cache" ||
        config.scraper == "import" ||
@@ -1184,12 +2087,25 @@ void Skyscraper::loadConfig(const QCommandLineParser &parser)
        config.scraper == "screenscraper") {
       config.interactive = false;
     } else {
-      config.threads = 1;
+      // The threads search and fetch the next files in the background while the user decides
+      // on the current one. The user is only asked about one file at a time
+      config.threads = qMin(config.threads, INTERACTIVEPREFETCH + 1);
+      config.autoThreads = false;
       config.minMatch = 0;
       config.refresh = true;
     }
   }
 
+  // Nobody is around to answer questions when running several platforms in one go or when
+  // running as a daemon
+  if(config.batch || config.daemon) {
+    if(!config.unattendSkip) {
+      config.unattend = true;
+    }
+    config.interactive = false;
+    config.watch = false;
+  }
+
   if(config.scraper == "import") {
     // Always force the cache to be refreshed when using import scraper
     config.refresh = true;
@@ -1214,14 +2130,197 @@ void Skyscraper::loadConfig(const QCommandLineParser &parser)
     exit(1);
   }
   
-  QDir resDir("./resources");
-  QDirIterator resDirIt(resDir.absolutePath(),
-			QDir::Files | QDir::NoDotAndDotDot | QDir::NoSymLinks,
-			QDirIterator::Subdirectories);
-  while(resDirIt.hasNext()) {
-    QString resFile = resDirIt.next();
-    resFile = resFile.remove(0, resFile.indexOf("resources/") + 10); // Also cut off 'resources/'
-    config.resources[resFile] = QImage("resources/" + resFile);
+  if(!resourcesLoaded) {
+    QDir resDir("./resources");
+    QDirIterator resDirIt(resDir.absolutePath(),
+			  QDir::Files | QDir::NoDotAndDotDot | QDir::NoSymLinks,
+			  QDirIterator::Subdirectories);
+    while(resDirIt.hasNext()) {
+      QString resFile = resDirIt.next();
+      resFile = resFile.remove(0, resFile.indexOf("resources/") + 10); // Also cut off 'resources/'
+      sharedResources[resFile] = QImage("resources/" + resFile);
+    }
+    resourcesLoaded = true;
+  }
+  config.resources = sharedResources;
+
+  setupOutputs(settings);
+}
+
+void Skyscraper::updateFiles()
+{
+  QString current;
+  QString distro;
+
+  /* -----
+     Files that should ALWAYS be updated from distributed default files
+     ----- */
+
+  current = "config.ini.example";
+  distro = "/usr/local/etc/skyscraper/config.ini.example";
+  copyFile(distro, current);
+
+  current = "README.md";
+  distro = "/usr/local/etc/skyscraper/README.md";
+  copyFile(distro, current);
+
+  current = "hints.txt";
+  distro = "/usr/local/etc/skyscraper/hints.txt";
+  copyFile(distro, current);
+
+  current = "ARTWORK.md";
+  distro = "/usr/local/etc/skyscraper/ARTWORK.md";
+  copyFile(distro, current);
+
+  current = "artwork.xml.example1";
+  distro = "/usr/local/etc/skyscraper/artwork.xml.example1";
+  copyFile(distro, current);
+
+  current = "artwork.xml.example2";
+  distro = "/usr/local/etc/skyscraper/artwork.xml.example2";
+  copyFile(distro, current);
+
+  current = "artwork.xml.example3";
+  distro = "/usr/local/etc/skyscraper/artwork.xml.example3";
+  copyFile(distro, current);
+
+  current = "artwork.xml.example4";
+  distro = "/usr/local/etc/skyscraper/artwork.xml.example4";
+  copyFile(distro, current);
+
+  current = "mameMap.csv";
+  distro = "/usr/local/etc/skyscraper/mameMap.csv";
+  copyFile(distro, current);
+  
+  current = "tgdb_developers.json";
+  distro = "/usr/local/etc/skyscraper/tgdb_developers.json";
+  copyFile(distro, current);
+
+  current = "tgdb_publishers.json";
+  distro = "/usr/local/etc/skyscraper/tgdb_publishers.json";
+  copyFile(distro, current);
+
+  current = "resources/boxfront.png";
+  distro = "/usr/local/etc/skyscraper/resources/boxfront.png";
+  copyFile(distro, current);
+
+  current = "resources/boxside.png";
+  distro = "/usr/local/etc/skyscraper/resources/boxside.png";
+  copyFile(distro, current);
+
+  current = "cache/README.md";
+  distro = "/usr/local/etc/skyscraper/docs/CACHE.md";
+  copyFile(distro, current);
+
+  current = "cache/priorities.xml.example";
+  distro = "/usr/local/etc/skyscraper/cache/priorities.xml.example";
+  copyFile(distro, current);
+
+  current = "import/README.md";
+  distro = "/usr/local/etc/skyscraper/import/IMPORT.md";
+  copyFile(distro, current);
+
+  current = "import/definitions.dat.example1";
+  distro = "/usr/local/etc/skyscraper/import/definitions.dat.example1";
+  copyFile(distro, current);
+
+  current = "import/definitions.dat.example2";
+  distro = "/usr/local/etc/skyscraper/import/definitions.dat.example2";
+  copyFile(distro, current);
+
+  /* -----
+    Files that will only be overwritten if they don't already exist
+    ----- */
+
+  current = "artwork.xml";
+  distro = "/usr/local/etc/skyscraper/artwork.xml";
+  copyFile(distro, current, false); // False means it won't overwrite if it exists
+
+  current = "aliasMap.csv";
+  distro = "/usr/local/etc/skyscraper/aliasMap.csv";
+  copyFile(distro, current, false);
+
+  current = "resources/maskexample.png";
+  distro = "/usr/local/etc/skyscraper/resources/maskexample.png";
+  copyFile(distro, current, false);
+
+  current = "resources/frameexample.png";
+  distro = "/usr/local/etc/skyscraper/resources/frameexample.png";
+  copyFile(distro, current, false);
+
+  current = "resources/scanlines1.png";
+  distro = "/usr/local/etc/skyscraper/resources/scanlines1.png";
+  copyFile(distro, current, false);
+
+  current = "resources/scanlines2.png";
+  distro = "/usr/local/etc/skyscraper/resources/scanlines2.png";
+  copyFile(distro, current, false);
+
+  // Copy one of the example definitions.dat files if none exists
+  current = "import/definitions.dat";
+  distro = "/usr/local/etc/skyscraper/import/definitions.dat.example2";
+  copyFile(distro, current, false);
+
+  /* -----
+     END updating files from distribution files
+    ----- */
+}
+
+// Sets up the additional frontends. Their game list and media folders default to what the
+// frontend itself uses, but can be set in a '[<FRONTEND>]' section in config.ini
+void Skyscraper::setupOutputs(QSettings &settings)
+{
+  foreach(QString frontendName, config.extraFrontends) {
+    QSharedPointer<FrontendOutput> output(new FrontendOutput);
+    output->config = config;
+    output->config.frontend = frontendName;
+    if(frontendName == "emulationstation") {
+      output->frontend = new EmulationStation;
+    } else {
+      output->frontend = new AttractMode;
+    }
+    output->frontend->setConfig(&output->config);
+
+    settings.beginGroup(frontendName);
+    // The frontend specific options are read before the requirements are checked, since the
+    // first frontend might not use them at all
+    if(settings.contains("emulator")) {
+      output->config.emulator = settings.value("emulator").toString();
+    }
+    output->frontend->checkReqs();
+    // Like in '[main]' the platform is added to the folders, since the section is used for
+    // all platforms
+    if(settings.contains("gamelistFolder")) {
+      QString gamelistFolder = settings.value("gamelistFolder").toString();
+      output->config.gameListFolder = gamelistFolder + (gamelistFolder.right(1) == "/"?"":"/") + config.platform;
+    } else {
+      output->config.gameListFolder = output->frontend->getGameListFolder();
+    }
+    if(settings.contains("mediaFolder")) {
+      QString mediaFolder = settings.value("mediaFolder").toString();
+      output->config.mediaFolder = mediaFolder + (mediaFolder.right(1) == "/"?"":"/") + config.platform;
+    } else {
+      output->config.mediaFolder = output->config.gameListFolder + "/media";
+    }
+    if(settings.contains("artworkXml")) {
+      output->config.artworkConfig = settings.value("artworkXml").toString();
+      QFile artworkFile(output->config.artworkConfig);
+      if(artworkFile.open(QIODevice::ReadOnly)) {
+	output->config.artworkXml = artworkFile.readAll();
+	artworkFile.close();
+      } else {
+	printf("Couldn't read artwork xml file '\033[1;32m%s\033[0m'. Please check file and permissions. Now exiting...\n", output->config.artworkConfig.toStdString().c_str());
+	exit(1);
+      }
+    }
+    settings.endGroup();
+
+    output->config.coversFolder = output->frontend->getCoversFolder();
+    output->config.screenshotsFolder = output->frontend->getScreenshotsFolder();
+    output->config.wheelsFolder = output->frontend->getWheelsFolder();
+    output->config.marqueesFolder = output->frontend->getMarqueesFolder();
+    output->config.videosFolder = output->frontend->getVideosFolder();
+    outputs.append(output);
   }
 }
 
@@ -1267,8 +2366,10 @@ void Skyscraper::doPrescrapeJobs()
   QEventLoop q; // Event loop for use when waiting for data from NetComm.
   connect(&manager, &NetComm::dataReady, &q, &QEventLoop::quit);
   
-  if(config.platform == "amiga" &&
-     config.scraper != "cache" && config.scraper != "import" && config.scraper != "esgamelist") {
+  if(config.platform == "amiga" && !whdLoadFetched &&
+     config.scraper != "cache" && config.scraper != "import" && config.scraper != "esgamelist" &&
+     config.scraper != "fake") {
+    whdLoadFetched = true;
     printf("Fetching 'whdload_db.xml', just a sec...");
     manager.request("https://raw.githubusercontent.com/HoraceAndTheSpider/Amiberry-XML-Builder/master/whdload_db.xml");
     q.exec();
@@ -1286,18 +2387,11 @@ void Skyscraper::doPrescrapeJobs()
     }
   }
 
-  if(config.scraper == "arcadedb" && config.threads != 1) {
-    printf("\033[1;33mForcing 1 thread to accomodate limits in ArcadeDB scraping module\033[0m\n\n");
-    config.threads = 1;
-  } else if(config.scraper == "openretro" && config.threads != 1) {
-    printf("\033[1;33mForcing 1 thread to accomodate limits in OpenRetro scraping module\033[0m\n\n");
-    config.threads = 1;
-  } else if(config.scraper == "igdb") {
+  // The module checks below are only done once per module when running several platforms
+  if(config.scraper == "igdb" && !checkedModules.contains("igdb")) {
+    checkedModules.insert("igdb");
     bool exitNow = false;
-    printf("\033[1;33mForcing 1 thread when using the IGDB scraping module\033[0m\n\n");
     printf("\033[1;32mTHIS MODULE IS POWERED BY IGDB.COM\033[0m\n");
-    config.threads = 1;
-    config.romLimit = 35;
     printf("Fetching key status, just a sec...\n");
     manager.request("https://api-v3.igdb.com/api_status", "", "user-key", StrTools::unMagic("136;213;169;133;171;147;206;117;211;152;214;221;209;213;157;197;136;158;212;220;171;211;160;215;202;172;216;125;172;174;151;171"));
     q.exec();
@@ -1329,9 +2423,11 @@ void Skyscraper::doPrescrapeJobs()
     if(exitNow)
       exit(1);
     printf("\n");
-  } else if(config.scraper == "mobygames" && config.threads != 1) {
-    printf("\033[1;33mForcing 1 thread to accomodate limits in MobyGames scraping module. Also be aware that MobyGames has a request limit of 360 requests per hour for the entire Skyscraper user base. So if someone else is currently using it, it will quit.\033[0m\n\n");
-    config.threads = 1;
+  }
+  if(config.scraper == "igdb") {
+    config.romLimit = 35;
+  } else if(config.scraper == "mobygames") {
+    printf("\033[1;33mBe aware that MobyGames has a request limit of 360 requests per hour for the entire Skyscraper user base. So if someone else is currently using it, it will quit.\033[0m\n\n");
     config.romLimit = 35;
   } else if(config.scraper == "screenscraper") {
     if(config.user.isEmpty() || config.password.isEmpty()) {
@@ -1340,27 +2436,99 @@ void Skyscraper::doPrescrapeJobs()
 	config.threads = 1;
       }
     } else {
-      printf("Fetching limits for user '%s', just a sec...\n", config.user.toStdString().c_str());
-      manager.request("https://www.screenscraper.fr/api2/ssuserInfos.php?devid=muldjord&devpassword=" + StrTools::unMagic("204;198;236;130;203;181;203;126;191;167;200;198;192;228;169;156") + "&softname=skyscraper" VERSION "&output=xml&ssid=" + config.user + "&sspassword=" + config.password);
-      q.exec();
-      QByteArray data = manager.getData();
-      QByteArray nodeBegin = "<maxthreads>";
-      QByteArray nodeEnd = "</maxthreads>";
-      int allowedThreads = QString(data.mid(data.indexOf(nodeBegin) + nodeBegin.length(), data.indexOf(nodeEnd) - (data.indexOf(nodeBegin) + nodeBegin.length()))).toInt();
-      if(allowedThreads != 0) {
-	if(config.threadsSet && config.threads <= allowedThreads) {
-	  printf("User is allowed %d threads, but user has set it lower manually, so ignoring.\n\n", allowedThreads);
+      if(!allowedThreads.contains(config.user)) {
+	allowedThreads[config.user] = fetchAllowedThreads();
+      }
+      int userThreads = allowedThreads.value(config.user);
+      if(userThreads != 0) {
+	if(config.threadsSet && config.threads <= userThreads) {
+	  printf("User is allowed %d threads, but user has set it lower manually, so ignoring.\n\n", userThreads);
 	} else {
-	  config.threads = (allowedThreads <= 8?allowedThreads:8);
+	  config.threads = (userThreads <= 8?userThreads:8);
 	  printf("Setting threads to %d as allowed for the supplied user credentials.\n\n", config.threads);
 	}
       }
     }
   }
+
+  setRateLimit();
+}
+
+// Asks ScreenScraper how many threads the user is allowed. Returns 0 if it couldn't be found
+int Skyscraper::fetchAllowedThreads()
+{
+  NetComm manager;
+  QEventLoop q; // Event loop for use when waiting for data from NetComm.
+  connect(&manager, &NetComm::dataReady, &q, &QEventLoop::quit);
+
+  printf("Fetching limits for user '%s', just a sec...\n", config.user.toStdString().c_str());
+  manager.request("https://www.screenscraper.fr/api2/ssuserInfos.php?devid=muldjord&devpassword=" + StrTools::unMagic("204;198;236;130;203;181;203;126;191;167;200;198;192;228;169;156") + "&softname=skyscraper" VERSION "&output=xml&ssid=" + config.user + "&sspassword=" + config.password);
+  q.exec();
+  QByteArray data = manager.getData();
+  QByteArray nodeBegin = "<maxthreads>";
+  QByteArray nodeEnd = "</maxthreads>";
+  return QString(data.mid(data.indexOf(nodeBegin) + nodeBegin.length(), data.indexOf(nodeEnd) - (data.indexOf(nodeBegin) + nodeBegin.length()))).toInt();
+}
+
+void Skyscraper::setThreads(const QString &threads)
+{
+  if(threads == "auto") {
+    // Start out with the maximum. Modules with lower limits will lower it before the run
+    config.autoThreads = true;
+    config.threads = AUTOTHREADSMAX;
+    config.threadsSet = false;
+  } else {
+    config.autoThreads = false;
+    config.threads = threads.toInt();
+    config.threadsSet = true;
+  }
+}
+
+void Skyscraper::setRateLimit()
+{
+  // Default request limits for the modules that document them. These are shared by all
+  // threads. Other modules are only limited if the user sets a limit
+  double rate = 0.0;
+  int burst = 1;
+  if(config.scraper == "screenscraper") {
+    // One request per second per allowed thread
+    rate = config.threads;
+    burst = config.threads;
+  } else if(config.scraper == "mobygames") {
+    // 360 requests per hour
+    rate = 0.1;
+  } else if(config.scraper == "igdb") {
+    // 4 requests per second
+    rate = 4.0;
+    burst = 4;
+  }
+  if(config.rateLimit > 0.0) {
+    rate = config.rateLimit;
+  }
+  if(config.rateBurst > 0) {
+    burst = config.rateBurst;
+  }
+  if(config.batch && config.scraper != "cache" && config.scraper != "import" &&
+     config.scraper != "esgamelist") {
+    RateLimiter::setMaxActive(config.scraper, config.threads);
+  }
+  if(rate > 0.0) {
+    RateLimiter::setLimit(config.scraper, rate, burst);
+    if(config.verbosity >= 1) {
+      printf("Limiting '%s' to %.2f requests per second (burst %d) across all threads.\n\n", config.scraper.toStdString().c_str(), rate, burst);
+    }
+  }
+  // Video downloads share their own budget so they can't starve the other requests
+  RateLimiter::setBandwidth(NET_VIDEO, config.videoBandwidth * 1000);
 }
 
 void Skyscraper::loadAliasMap()
 {
+  if(aliasMapLoaded) {
+    config.aliasMap = sharedAliasMap;
+    return;
+  }
+  aliasMapLoaded = true;
   if(!QFileInfo::exists("aliasMap.csv"))
     return;
   QFile aliasMapFile("aliasMap.csv");
@@ -1376,10 +2544,11 @@ void Skyscraper::loadAliasMap()
       QString aliasName = pair.at(1);
       baseName = baseName.replace("\"", "").simplified();
       aliasName = aliasName.replace("\"", "").simplified();
-      config.aliasMap[baseName] = aliasName;
+      sharedAliasMap[baseName] = aliasName;
     }
     aliasMapFile.close();
   }
+  config.aliasMap = sharedAliasMap;
 }
 
 void Skyscraper::loadMameMap()
@@ -1391,6 +2560,11 @@ void Skyscraper::loadMameMap()
       config.platform == "mame-libretro" ||
       config.platform == "mame-mame4all" ||
       config.platform == "fba")) {
+    if(mameMapLoaded) {
+      config.mameMap = sharedMameMap;
+      return;
+    }
+    mameMapLoaded = true;
     QFile mameMapFile("mameMap.csv");
     if(mameMapFile.open(QIODevice::ReadOnly)) {
       while(!mameMapFile.atEnd()) {
@@ -1401,10 +2575,11 @@ void Skyscraper::loadMameMap()
 	QString realName = pair.at(1);
 	mameName = mameName.replace("\"", "").simplified();
 	realName = realName.replace("\"", "").simplified();
-	config.mameMap[mameName] = realName;
+	sharedMameMap[mameName] = realName;
       }
       mameMapFile.close();
     }
+    config.mameMap = sharedMameMap;
   }
 }
 
@@ -1412,6 +2587,11 @@ void Skyscraper::loadMameMap()
 void Skyscraper::loadWhdLoadMap()
 {
   if(config.platform == "amiga") {
+    if(whdLoadMapLoaded) {
+      config.whdLoadMap = sharedWhdLoadMap;
+      return;
+    }
+    whdLoadMapLoaded = true;
     QDomDocument doc;
 
     QFile whdLoadFile;
@@ -1432,10 +2612,11 @@ void Skyscraper::loadWhdLoadMap()
 	  QPair<QString, QString> gamePair;
 	  gamePair.first = gameNode.firstChildElement("name").text();
 	  gamePair.second = gameNode.firstChildElement("variant_uuid").text();
-	  config.whdLoadMap[gameNode.toElement().attribute("filename")] = gamePair;
+	  sharedWhdLoadMap[gameNode.toElement().attribute("filename")] = gamePair;
 	}
       }
     }
+    config.whdLoadMap = sharedWhdLoadMap;
   }
 }
 
@@ -26,10 +26,18 @@
 #ifndef SKYSCRAPER_H
 #define SKYSCRAPER_H
 
+#include <functional>
+
 #include <QObject>
 #include <QFile>
 #include <QTime>
 #include <QCommandLineParser>
+#include <QFileSystemWatcher>
+#include <QTimer>
+#include <QMap>
+#include <QSettings>
+#include <QSet>
+#include <QImage>
 
 #include "netcomm.h"
 #include "scraperworker.h"
@@ -37,60 +45,166 @@
 #include "abstractfrontend.h"
 #include "settings.h"
 #include "platform.h"
+#include "entryspill.h"
+
+// Milliseconds to wait after the last change in the input folder before checking it in watch mode
+#define WATCHDELAY 10000
+// Milliseconds between each check of the free disk space while scraping
+#define SPACECHECKINTERVAL 5000
+// Finished game list entries are only moved to disk once there's at least this many of them
+#define SPILLMINENTRIES 100
+// Number of threads handling the files that are already in the resource cache while the
+// remaining threads do the network scraping
+#define CACHEDTHREADS 2
+// Number of threads generating game list entries in single pass mode
+#define GENERATETHREADS 2
+// Milliseconds to wait after the last scraped file before writing the cache in daemon mode
+#define DAEMONWRITEDELAY 30000
+// Max number of files searched and fetched ahead while the user chooses an entry in
+// interactive mode
+#define INTERACTIVEPREFETCH 3
 
 class Skyscraper : public QObject
 {
   Q_OBJECT
 
 public:
-  Skyscraper(const QCommandLineParser &parser, const QString &currentDir);
+  Skyscraper(const QCommandLineParser &parser, const QString &currentDir,
+	     const QString &platform = QString(), const QString &scraper = QString(),
+	     const bool &daemon = false);
   ~Skyscraper();
   QSharedPointer<Queue> queue;
   bool threadsRunning = false;
+  bool watchMode = false;
+  void stopRun();
+  bool prepare();
+  void serve(const QFileInfo &info, const bool &composite, const bool &refresh,
+	     std::function<void(const GameEntry &entry)> done);
 
 public slots:
   void run();
+  void flushCache();
 
 signals:
   void finished();
+  void hashingDone();
 
 private slots:
-  void entryReady(GameEntry entry, QString output, QString debug);
+  void entryReady(GameEntry entry, ScrapeReport report);
   void checkThreads();
+  void inputChanged(const QString &path);
+  void checkWatched();
+  void checkSpace();
+  void checkMemory();
+  void budgetReached();
+  void generatedEntry(GameEntry entry, ScrapeReport report);
+  void resourceThreadDone();
+  void outputEntry(int output, GameEntry entry);
+  void hashThreadDone();
+  void printHeldOutput();
   
 private:
   Settings config;
-  void loadConfig(const QCommandLineParser &parser);
+  void loadConfig(const QCommandLineParser &parser, const QString &platform,
+		  const QString &scraper);
+  void updateFiles();
   void copyFile(QString &distro, QString &current, bool overwrite = true);
   QString secsToString(const int &seconds);
   void checkForFolder(QDir &folder, bool create = true);
   void showHint();
   void doPrescrapeJobs();
+  int fetchAllowedThreads();
+  QString renderOutput(const GameEntry &entry, const ScrapeReport &report);
+  void setThreads(const QString &threads);
+  void openCheckpoint(QList<QFileInfo> &infoList);
+  void applyShard(QList<QFileInfo> &infoList);
+  void setRateLimit();
   void loadAliasMap();
   void loadMameMap();
   void loadWhdLoadMap();
   void setRegionPrios();
   void setLangPrios();
   void migrate(QString filename);
+  void runHashBenchmark(const QList<QFileInfo> &nameOrder);
+  void startThreads(const QString &scraper);
+  void createCompositors();
+  void printOutput(const QString &text);
+  void writeGameList();
+  void writeGameList(AbstractFrontend *listFrontend, QList<GameEntry> &entries,
+		     const QString &fileString);
+  void setupOutputs(QSettings &settings);
+  void startWatching();
+  void updateWatchedDirs();
+  QMap<QString, QFileInfo> scanInputFolder();
+  void startRound(const QString &scraper);
+  QThread *createScraperThread(QSharedPointer<BoundedQueue<HashedEntry> > inputQueue,
+			       QSharedPointer<ThreadGovernor> governor,
+			       const Settings &threadConfig, const QString &threadId,
+			       const bool &generator = false,
+			       QSharedPointer<BoundedQueue<VideoJob> > videoQueue = QSharedPointer<BoundedQueue<VideoJob> >());
   
   AbstractFrontend *frontend;
+  QList<QSharedPointer<FrontendOutput> > outputs;
 
   QSharedPointer<Cache> cache;
+  QSharedPointer<BoundedQueue<HashedEntry> > hashedQueue;
+  QSharedPointer<BoundedQueue<HashedEntry> > cachedQueue;
+  QSharedPointer<ThreadGovernor> governor;
+  QSharedPointer<BoundedQueue<HashedEntry> > generateQueue;
+  QSharedPointer<BoundedQueue<VideoJob> > videoQueue;
+  bool generating = false;
+  int resourceThreads;
+  int doneResourceThreads;
+  QSharedPointer<Compositor> compositor;
+  QSharedPointer<QThreadPool> compositorPool;
 
   QList<GameEntry> gameEntries;
+  EntrySpill entrySpill;
   QList<QString> cliFiles;
   QMutex entryMutex;
+  QStringList heldOutput;
   QMutex checkThreadMutex;
   QTime timer;
+  QFileSystemWatcher *watcher = nullptr;
+  QTimer watchTimer;
+  QMap<QString, QFileInfo> watchedFiles;
+  QList<QFileInfo> watchFiles;
+  QString currentScraper;
   QString gameListFileString;
   QString skippedFileString;
+  QFile skippedFile;
+  QTimer spaceTimer;
+  QTimer memTimer;
+  QString checkpointFileString;
+  QFile checkpointFile;
+  QTimer budgetTimer;
+  QTimer cacheWriteTimer;
   int doneThreads;
+  int runningThreads;
+  int hashThreads;
+  int doneHashThreads;
   int notFound;
   int found;
   int avgSearchMatch;
   int avgCompleteness;
   int currentFile;
   int totalFiles;
+
+  // Loaded once and then shared by all platforms when running several in batch mode
+  static bool filesUpdated;
+  static bool resourcesLoaded;
+  static QMap<QString, QImage> sharedResources;
+  static bool aliasMapLoaded;
+  static QMap<QString, QString> sharedAliasMap;
+  static bool mameMapLoaded;
+  static QMap<QString, QString> sharedMameMap;
+  static bool whdLoadMapLoaded;
+  static QMap<QString, QPair<QString, QString> > sharedWhdLoadMap;
+  static bool whdLoadFetched;
+  static QSet<QString> checkedModules;
+  static QMap<QString, int> allowedThreads;
+  // Caches are only shared in daemon mode, where several modules can be in use at once
+  static QMap<QString, QSharedPointer<Cache> > sharedCaches;
 };
 
 #endif // SKYSCRAPER_H
@@ -160,6 +160,7 @@ void TheGamesDb::getGameData(GameEntry &game)
       ;
     }
   }
+  waitForMedia();
 }
 
 void TheGamesDb::getReleaseDate(GameEntry &game)
@@ -216,24 +217,28 @@ void TheGamesDb::getCover(GameEntry &game)
 {
   // https://api.thegamesdb.net/Games/Boxart?games_id=88&apikey=XXX&filter=boxart,screenshot
   // https://cdn.thegamesdb.net/images/original/boxart/front/[gameid]-1.jpg
-  manager.request("https://cdn.thegamesdb.net/images/original/boxart/front/" + game.id + "-1.jpg");
-  q.exec();
-  QImage image;
-  if(image.loadFromData(manager.getData())) {
-    game.coverData = image;
-  }
+  fetchMedia("https://cdn.thegamesdb.net/images/original/boxart/front/" + game.id + "-1.jpg",
+	     [&game](const NetReply &reply) -> bool {
+	       QImage image;
+	       if(reply.error == QNetworkReply::NoError && image.loadFromData(reply.data)) {
+		 game.coverData = image;
+	       }
+	       return true;
+	     });
 }
 
 void TheGamesDb::getScreenshot(GameEntry &game)
 {
   // https://api.thegamesdb.net/Games/Boxart?games_id=88&apikey=XXX&filter=boxart,screenshot
   // https://cdn.thegamesdb.net/images/original/screenshots/[gameid]-1.jpg
-  manager.request("https://cdn.thegamesdb.net/images/original/screenshots/" + game.id + "-1.jpg");
-  q.exec();
-  QImage image;
-  if(image.loadFromData(manager.getData())) {
-    game.screenshotData = image;
-  }
+  fetchMedia("https://cdn.thegamesdb.net/images/original/screenshots/" + game.id + "-1.jpg",
+	     [&game](const NetReply &reply) -> bool {
+	       QImage image;
+	       if(reply.error == QNetworkReply::NoError && image.loadFromData(reply.data)) {
+		 game.screenshotData = image;
+	       }
+	       return true;
+	     });
 }
 
 void TheGamesDb::loadMaps()
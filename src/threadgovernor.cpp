@@ -0,0 +1,119 @@
+/***************************************************************************
+ *            threadgovernor.cpp
+ *
+ *  Sun Oct 18 15:38:45 UTC 2026
+ ****************************************************************************/
+/*
+ *  This file is part of skyscraper.
+ *
+ *  skyscraper is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  skyscraper is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with skyscraper; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA.
+ */
+
+#include <QMutexLocker>
+
+#include "threadgovernor.h"
+#include "netcomm.h"
+
+ThreadGovernor::ThreadGovernor(const int &maxThreads)
+{
+  this->maxThreads = qMax(1, maxThreads);
+  // Start in the middle and let the measurements decide which way to go
+  activeThreads = qMax(1, this->maxThreads / 2);
+  adjustTimer.setInterval(GOVERNORINTERVAL);
+  connect(&adjustTimer, &QTimer::timeout, this, &ThreadGovernor::adjust);
+}
+
+void ThreadGovernor::start()
+{
+  lastRequests = NetComm::getRequestCount();
+  lastErrors = NetComm::getErrorCount();
+  printf("\033[1;33mAuto threads: Starting with %d of %d threads\033[0m\n\n", activeThreads, maxThreads);
+  adjustTimer.start();
+}
+
+// Blocks the calling worker while its id is above the number of active threads
+void ThreadGovernor::waitForTurn(const int &workerId)
+{
+  QMutexLocker locker(&mutex);
+  while(workerId > activeThreads && !finished) {
+    turnChanged.wait(&mutex);
+  }
+}
+
+void ThreadGovernor::reportGame(const qint64 &msecs)
+{
+  QMutexLocker locker(&mutex);
+  games++;
+  gameTime += msecs;
+}
+
+// Called when there are no more files. Releases any waiting workers so they can quit
+void ThreadGovernor::finish()
+{
+  QMutexLocker locker(&mutex);
+  finished = true;
+  adjustTimer.stop();
+  turnChanged.wakeAll();
+}
+
+void ThreadGovernor::adjust()
+{
+  QMutexLocker locker(&mutex);
+  if(finished) {
+    return;
+  }
+  int requests = NetComm::getRequestCount() - lastRequests;
+  int errors = NetComm::getErrorCount() - lastErrors;
+  lastRequests += requests;
+  lastErrors += errors;
+  double errorRate = (requests > 0?(double)errors / (double)requests:0.0);
+  double throughput = (double)games * 60000.0 / (double)GOVERNORINTERVAL;
+  qint64 avgGameTime = (games > 0?gameTime / games:0);
+
+  int change = 0;
+  bool undo = false;
+  if(errorRate > 0.2) {
+    // Plenty of errors means the source is overloaded or limiting us, back off hard
+    change = -(activeThreads / 2);
+  } else if(errorRate > 0.05) {
+    change = -1;
+  } else if(lastThroughput < 0.0) {
+    // Nothing to compare with yet, probe upwards
+    change = 1;
+  } else if(lastChange > 0 && throughput > lastThroughput * 1.05) {
+    // More threads helped, keep going
+    change = 1;
+  } else if(lastChange > 0 ||
+	    (lastChange < 0 && throughput < lastThroughput * 0.95)) {
+    // The last change didn't pay off, undo it and stay there for a while
+    change = -lastChange;
+    undo = true;
+    holdIntervals = 3;
+  } else if(holdIntervals > 0) {
+    holdIntervals--;
+  } else {
+    change = 1;
+  }
+  int newThreads = qBound(1, activeThreads + change, maxThreads);
+  // An undo isn't judged by the next interval, it just returns to a level we already know
+  lastChange = (undo?0:newThreads - activeThreads);
+  lastThroughput = throughput;
+  games = 0;
+  gameTime = 0;
+
+  printf("\033[1;33mAuto threads: %d -> %d active (%.1f games/min, %lld ms per game, %d%% request errors)\033[0m\n", activeThreads, newThreads, throughput, avgGameTime, (int)(errorRate * 100.0));
+  activeThreads = newThreads;
+  turnChanged.wakeAll();
+}
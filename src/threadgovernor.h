@@ -0,0 +1,75 @@
+/***************************************************************************
+ *            threadgovernor.h
+ *
+ *  Sun Oct 18 15:38:45 UTC 2026
+ ****************************************************************************/
+/*
+ *  This file is part of skyscraper.
+ *
+ *  skyscraper is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  skyscraper is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with skyscraper; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA.
+ */
+
+#ifndef THREADGOVERNOR_H
+#define THREADGOVERNOR_H
+
+#include <QObject>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QTimer>
+
+// Upper limit for '-t auto'. Scraping modules with lower limits will lower it
+#define AUTOTHREADSMAX 8
+// Milliseconds between each adjustment of the number of active threads
+#define GOVERNORINTERVAL 20000
+
+// Used with '-t auto'. All threads up to the maximum are started, but only the currently
+// active ones take on new files. The number of active threads is adjusted as the run
+// progresses based on throughput, time spent per game and the network error rate
+class ThreadGovernor : public QObject
+{
+  Q_OBJECT
+
+public:
+  ThreadGovernor(const int &maxThreads);
+  void start();
+  void waitForTurn(const int &workerId);
+  void reportGame(const qint64 &msecs);
+  void finish();
+
+private slots:
+  void adjust();
+
+private:
+  QMutex mutex;
+  QWaitCondition turnChanged;
+  QTimer adjustTimer;
+  int maxThreads;
+  int activeThreads;
+  bool finished = false;
+
+  // Measurements for the current interval
+  int games = 0;
+  qint64 gameTime = 0;
+  int lastRequests = 0;
+  int lastErrors = 0;
+
+  // Result of the previous interval, used to decide if the last change was an improvement
+  double lastThroughput = -1.0;
+  int lastChange = 0;
+  int holdIntervals = 0;
+
+};
+
+#endif // THREADGOVERNOR_H
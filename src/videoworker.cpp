@@ -0,0 +1,80 @@
+/***************************************************************************
+ *            videoworker.cpp
+ *
+ *  Sun Oct 18 16:08:04 UTC 2026
+ ****************************************************************************/
+/*
+ *  This file is part of skyscraper.
+ *
+ *  skyscraper is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  skyscraper is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with skyscraper; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA.
+ */
+
+#include "videoworker.h"
+#include "netcomm.h"
+#include "ratelimiter.h"
+#include "memoryguard.h"
+
+VideoWorker::VideoWorker(QSharedPointer<BoundedQueue<VideoJob> > videoQueue,
+			 QSharedPointer<Cache> cache, const Settings &config)
+{
+  this->videoQueue = videoQueue;
+  this->cache = cache;
+  this->config = config;
+}
+
+VideoWorker::~VideoWorker()
+{
+}
+
+void VideoWorker::run()
+{
+  NetComm manager;
+  VideoJob job;
+  forever {
+    // Each video is held in memory until it's in the cache
+    MemoryGuard::throttle();
+    if(!videoQueue->pop(job)) {
+      break;
+    }
+    QList<MediaRequest> requests = job.requests;
+    while(!requests.isEmpty()) {
+      QList<MediaRequest> retries;
+      foreach(MediaRequest request, requests) {
+	if(request.limited) {
+	  RateLimiter::acquire(config.scraper);
+	}
+	manager.requestAsync(request.url, [request, &retries](const NetReply &reply) {
+	    if(!request.handler(reply) && request.retries > 0) {
+	      MediaRequest retry = request;
+	      retry.retries--;
+	      retries.append(retry);
+	    }
+	  }, "", "", "", NET_VIDEO);
+      }
+      manager.waitForAll();
+      requests = retries;
+    }
+    // Only the video is added, the rest of the game's resources are already in the cache
+    GameEntry videoEntry;
+    videoEntry.sha1 = job.game->sha1;
+    videoEntry.source = config.scraper;
+    videoEntry.videoData = job.game->videoData;
+    videoEntry.videoFormat = job.game->videoFormat;
+    if(!videoEntry.videoData.isEmpty() && !videoEntry.videoFormat.isEmpty()) {
+      cache->addResources(videoEntry, config);
+    }
+  }
+  emit allDone();
+}
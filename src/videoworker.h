@@ -0,0 +1,69 @@
+/***************************************************************************
+ *            videoworker.h
+ *
+ *  Sun Oct 18 16:08:04 UTC 2026
+ ****************************************************************************/
+/*
+ *  This file is part of skyscraper.
+ *
+ *  skyscraper is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  skyscraper is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with skyscraper; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA.
+ */
+
+#ifndef VIDEOWORKER_H
+#define VIDEOWORKER_H
+
+#include <QObject>
+#include <QSharedPointer>
+
+#include "abstractscraper.h"
+#include "boundedqueue.h"
+#include "cache.h"
+#include "settings.h"
+
+// Max number of games waiting for their videos to be downloaded
+#define VIDEOQUEUESIZE 256
+// Number of threads downloading videos while the scraper threads carry on
+#define VIDEOTHREADS 1
+
+// The video requests of a scraped game. The handlers write to 'game', so it is kept alive
+// here until they have been called
+struct VideoJob {
+  QSharedPointer<GameEntry> game;
+  QList<MediaRequest> requests;
+};
+
+// Downloads videos in the background and adds them to the cache, so a few large videos
+// don't hold up the scraper threads while the metadata and artwork of other games are waiting
+class VideoWorker : public QObject
+{
+  Q_OBJECT
+
+public:
+  VideoWorker(QSharedPointer<BoundedQueue<VideoJob> > videoQueue, QSharedPointer<Cache> cache,
+	      const Settings &config);
+  ~VideoWorker();
+  void run();
+
+signals:
+  void allDone();
+
+private:
+  QSharedPointer<BoundedQueue<VideoJob> > videoQueue;
+  QSharedPointer<Cache> cache;
+  Settings config;
+
+};
+
+#endif // VIDEOWORKER_H
@@ -0,0 +1,221 @@
+/***************************************************************************
+ *            zipreader.cpp
+ *
+ *  Sun Oct 18 15:15:25 UTC 2026
+ ****************************************************************************/
+/*
+ *  This file is part of skyscraper.
+ *
+ *  skyscraper is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  skyscraper is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with skyscraper; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA.
+ */
+
+#include <zlib.h>
+
+#include "zipreader.h"
+
+#define CHUNKSIZE 65536
+
+// Zip structures are always little endian
+static quint16 getUInt16(const QByteArray &data, int pos)
+{
+  return (quint8)data.at(pos) | ((quint8)data.at(pos + 1) << 8);
+}
+
+static quint32 getUInt32(const QByteArray &data, int pos)
+{
+  return (quint32)getUInt16(data, pos) | ((quint32)getUInt16(data, pos + 2) << 16);
+}
+
+ZipReader::ZipReader(const QString &fileName)
+{
+  zipFile.setFileName(fileName);
+}
+
+ZipReader::~ZipReader()
+{
+  if(zipFile.isOpen()) {
+    zipFile.close();
+  }
+}
+
+bool ZipReader::readCentralDirectory()
+{
+  entries.clear();
+  if(!zipFile.isOpen() && !zipFile.open(QIODevice::ReadOnly)) {
+    return false;
+  }
+
+  // The 'end of central directory' record is 22 bytes plus an optional comment of up to
+  // 65535 bytes, so it must be located within the last 65557 bytes of the file
+  qint64 tailSize = qMin(zipFile.size(), (qint64)(22 + 65535));
+  if(tailSize < 22 || !zipFile.seek(zipFile.size() - tailSize)) {
+    return false;
+  }
+  QByteArray tail = zipFile.read(tailSize);
+  int eocdPos = tail.lastIndexOf(QByteArray("PK\x05\x06", 4));
+  if(eocdPos == -1 || eocdPos + 22 > tail.size()) {
+    return false;
+  }
+  int totalEntries = getUInt16(tail, eocdPos + 10);
+  quint32 cdSize = getUInt32(tail, eocdPos + 12);
+  quint32 cdOffset = getUInt32(tail, eocdPos + 16);
+  // 0xFFFFFFFF means the real values are stored in a zip64 record which we don't support
+  if(cdOffset == 0xFFFFFFFF || cdSize == 0xFFFFFFFF ||
+     (qint64)cdOffset + cdSize > zipFile.size()) {
+    return false;
+  }
+
+  if(!zipFile.seek(cdOffset)) {
+    return false;
+  }
+  QByteArray cd = zipFile.read(cdSize);
+  int pos = 0;
+  for(int a = 0; a < totalEntries; ++a) {
+    if(pos + 46 > cd.size() || getUInt32(cd, pos) != 0x02014b50) {
+      entries.clear();
+      return false;
+    }
+    quint16 flags = getUInt16(cd, pos + 8);
+    ZipEntry entry;
+    entry.method = getUInt16(cd, pos + 10);
+    entry.crc = getUInt32(cd, pos + 16);
+    entry.compressedSize = getUInt32(cd, pos + 20);
+    entry.uncompressedSize = getUInt32(cd, pos + 24);
+    int nameLength = getUInt16(cd, pos + 28);
+    int extraLength = getUInt16(cd, pos + 30);
+    int commentLength = getUInt16(cd, pos + 32);
+    entry.localHeaderOffset = getUInt32(cd, pos + 42);
+    entry.fileName = QString::fromUtf8(cd.mid(pos + 46, nameLength));
+    pos += 46 + nameLength + extraLength + commentLength;
+
+    // Skip folder entries, we only care about actual files
+    if(entry.fileName.right(1) == "/") {
+      continue;
+    }
+    // Flag bit 0 means the entry is encrypted. Mark it as unsupported
+    if(flags & 0x0001) {
+      entry.method = 0xFFFF;
+    }
+    entries.append(entry);
+  }
+  return true;
+}
+
+QList<ZipEntry> ZipReader::getEntries()
+{
+  return entries;
+}
+
+bool ZipReader::canDecompress(const ZipEntry &entry)
+{
+  if(entry.method != ZIP_STORED && entry.method != ZIP_DEFLATED) {
+    return false;
+  }
+  if(entry.compressedSize == 0xFFFFFFFF || entry.uncompressedSize == 0xFFFFFFFF ||
+     entry.localHeaderOffset == 0xFFFFFFFF) {
+    return false;
+  }
+  return true;
+}
+
+bool ZipReader::decompress(const ZipEntry &entry,
+			   std::function<void(const char *data, int len)> dataSink)
+{
+  if(!canDecompress(entry)) {
+    return false;
+  }
+  if(!zipFile.isOpen() && !zipFile.open(QIODevice::ReadOnly)) {
+    return false;
+  }
+
+  // The local header can have a different 'extra' field length than the central directory,
+  // so we need to read it to find the actual start of the data
+  if(!zipFile.seek(entry.localHeaderOffset)) {
+    return false;
+  }
+  QByteArray localHeader = zipFile.read(30);
+  if(localHeader.size() != 30 || getUInt32(localHeader, 0) != 0x04034b50) {
+    return false;
+  }
+  qint64 dataOffset = (qint64)entry.localHeaderOffset + 30 +
+    getUInt16(localHeader, 26) + getUInt16(localHeader, 28);
+  if(!zipFile.seek(dataOffset)) {
+    return false;
+  }
+
+  // The data is checked against the crc from the central directory, so a corrupt archive
+  // fails like it does when unpacking with '7z'
+  uLong crc = crc32(0L, Z_NULL, 0);
+  qint64 remaining = entry.compressedSize;
+  if(entry.method == ZIP_STORED) {
+    while(remaining > 0) {
+      QByteArray chunk = zipFile.read(qMin(remaining, (qint64)CHUNKSIZE));
+      if(chunk.isEmpty()) {
+	return false;
+      }
+      crc = crc32(crc, (const Bytef *)chunk.constData(), chunk.size());
+      dataSink(chunk.constData(), chunk.size());
+      remaining -= chunk.size();
+    }
+    return crc == entry.crc;
+  }
+
+  z_stream stream;
+  stream.zalloc = Z_NULL;
+  stream.zfree = Z_NULL;
+  stream.opaque = Z_NULL;
+  stream.avail_in = 0;
+  stream.next_in = Z_NULL;
+  // Negative window bits tells zlib to expect raw deflate data without zlib headers
+  if(inflateInit2(&stream, -MAX_WBITS) != Z_OK) {
+    return false;
+  }
+
+  QByteArray outBuffer(CHUNKSIZE, '\0');
+  qint64 totalOut = 0;
+  int result = Z_OK;
+  while(result != Z_STREAM_END && remaining > 0) {
+    QByteArray chunk = zipFile.read(qMin(remaining, (qint64)CHUNKSIZE));
+    if(chunk.isEmpty()) {
+      break;
+    }
+    remaining -= chunk.size();
+    stream.avail_in = chunk.size();
+    stream.next_in = (Bytef *)chunk.data();
+    do {
+      stream.avail_out = CHUNKSIZE;
+      stream.next_out = (Bytef *)outBuffer.data();
+      result = inflate(&stream, Z_NO_FLUSH);
+      // Z_BUF_ERROR just means zlib needs more input before it can continue
+      if(result == Z_BUF_ERROR) {
+	result = Z_OK;
+	break;
+      }
+      if(result != Z_OK && result != Z_STREAM_END) {
+	inflateEnd(&stream);
+	return false;
+      }
+      int produced = CHUNKSIZE - stream.avail_out;
+      if(produced > 0) {
+	crc = crc32(crc, (const Bytef *)outBuffer.constData(), produced);
+	dataSink(outBuffer.constData(), produced);
+	totalOut += produced;
+      }
+    } while(stream.avail_out == 0 && result != Z_STREAM_END);
+  }
+  inflateEnd(&stream);
+
+  return result == Z_STREAM_END && totalOut == entry.uncompressedSize && crc == entry.crc;
+}
@@ -0,0 +1,64 @@
+/***************************************************************************
+ *            zipreader.h
+ *
+ *  Sun Oct 18 15:15:25 UTC 2026
+ ****************************************************************************/
+/*
+ *  This file is part of skyscraper.
+ *
+ *  skyscraper is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  skyscraper is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with skyscraper; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA.
+ */
+
+#ifndef ZIPREADER_H
+#define ZIPREADER_H
+
+#include <functional>
+
+#include <QFile>
+#include <QList>
+#include <QString>
+
+#define ZIP_STORED 0
+#define ZIP_DEFLATED 8
+
+struct ZipEntry {
+  QString fileName = "";
+  quint16 method = 0;
+  quint32 crc = 0;
+  quint32 compressedSize = 0;
+  quint32 uncompressedSize = 0;
+  quint32 localHeaderOffset = 0;
+};
+
+// Reads zip archives in-process. Only 'stored' and 'deflated' entries are supported,
+// anything else (zip64, encryption, bzip2 etc.) should be handled by falling back to '7z'
+class ZipReader
+{
+public:
+  ZipReader(const QString &fileName);
+  ~ZipReader();
+  bool readCentralDirectory();
+  QList<ZipEntry> getEntries();
+  bool canDecompress(const ZipEntry &entry);
+  bool decompress(const ZipEntry &entry,
+		  std::function<void(const char *data, int len)> dataSink);
+
+private:
+  QFile zipFile;
+  QList<ZipEntry> entries;
+
+};
+
+#endif // ZIPREADER_H